@@ -33,6 +33,10 @@ namespace nexus {
     /// Hook at the end of the event loop
     void EndOfEventAction(const G4Event*);
 
+    /// Energy window of the events saved to file
+    G4double GetMinEnergy() const;
+    G4double GetMaxEnergy() const;
+
   private:
     G4GenericMessenger* msg_;
     G4int nevt_, nupdate_;
@@ -40,6 +44,9 @@ namespace nexus {
     G4double energy_max_;
   };
 
+  inline G4double DefaultEventAction::GetMinEnergy() const { return energy_min_; }
+  inline G4double DefaultEventAction::GetMaxEnergy() const { return energy_max_; }
+
 } // namespace nexus
 
 #endif
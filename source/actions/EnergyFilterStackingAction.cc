@@ -0,0 +1,107 @@
+// ----------------------------------------------------------------------------
+// nexus | EnergyFilterStackingAction.cc
+//
+// This stacking action tracks events in two stages. Optical photons and
+// ionization electrons are kept in the waiting stack until all the other
+// particles have been tracked. At that point the energy deposited in the
+// event is final, and if it is outside the window of the DefaultEventAction
+// the event is finished without tracking them, since it will not be saved.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "EnergyFilterStackingAction.h"
+#include "DefaultEventAction.h"
+#include "Trajectory.h"
+#include "IonizationElectron.h"
+#include "FactoryBase.h"
+
+#include <G4Track.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4EventManager.hh>
+#include <G4Event.hh>
+#include <G4TrajectoryContainer.hh>
+#include <G4StackManager.hh>
+
+
+using namespace nexus;
+
+REGISTER_CLASS(EnergyFilterStackingAction, G4UserStackingAction)
+
+EnergyFilterStackingAction::EnergyFilterStackingAction():
+  G4UserStackingAction(), first_stage_(true)
+{
+}
+
+
+
+EnergyFilterStackingAction::~EnergyFilterStackingAction()
+{
+}
+
+
+
+G4ClassificationOfNewTrack
+EnergyFilterStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  // Once the energy filter is passed, tracks are processed as they come
+  // (e.g. EL photons right after being emitted), so that the waiting
+  // stack does not pile up all the photons of the event
+  if (!first_stage_) return fUrgent;
+
+  G4ParticleDefinition* pdef = track->GetDefinition();
+
+  if (pdef == G4OpticalPhoton::Definition() ||
+      pdef == IonizationElectron::Definition())
+    return fWaiting;
+
+  return fUrgent;
+}
+
+
+
+void EnergyFilterStackingAction::NewStage()
+{
+  // The decision is taken only once, when all the
+  // particles depositing energy have been tracked
+  if (!first_stage_) return;
+  first_stage_ = false;
+
+  G4EventManager* evtmgr = G4EventManager::GetEventManager();
+
+  DefaultEventAction* evtact =
+    dynamic_cast<DefaultEventAction*>(evtmgr->GetUserEventAction());
+  if (!evtact) {
+    G4Exception("[EnergyFilterStackingAction]", "NewStage()", FatalException,
+                "DefaultEventAction is required when using EnergyFilterStackingAction");
+    return;
+  }
+
+  G4TrajectoryContainer* tc =
+    evtmgr->GetConstCurrentEvent()->GetTrajectoryContainer();
+  if (!tc) {
+    G4Exception("[EnergyFilterStackingAction]", "NewStage()", FatalException,
+                "DefaultTrackingAction is required when using EnergyFilterStackingAction");
+    return;
+  }
+
+  G4double edep = 0.;
+  for (size_t i=0; i<tc->size(); ++i) {
+    Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
+    if (trj) edep += trj->GetEnergyDeposit();
+  }
+
+  // Same condition used by the event action to save the event
+  if (edep > evtact->GetMinEnergy() && edep < evtact->GetMaxEnergy()) return;
+
+  // The event will not be saved: drop the optical photons
+  // and ionization electrons without tracking them
+  stackManager->clear();
+}
+
+
+
+void EnergyFilterStackingAction::PrepareNewEvent()
+{
+  first_stage_ = true;
+}
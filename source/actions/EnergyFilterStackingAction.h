@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// nexus | EnergyFilterStackingAction.h
+//
+// This stacking action tracks events in two stages. Optical photons and
+// ionization electrons are kept in the waiting stack until all the other
+// particles have been tracked. At that point the energy deposited in the
+// event is final, and if it is outside the window of the DefaultEventAction
+// the event is finished without tracking them, since it will not be saved.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ENERGY_FILTER_STACKING_ACTION_H
+#define ENERGY_FILTER_STACKING_ACTION_H
+
+#include <G4UserStackingAction.hh>
+
+
+namespace nexus {
+
+  class EnergyFilterStackingAction: public G4UserStackingAction
+  {
+  public:
+    /// Constructor
+    EnergyFilterStackingAction();
+    /// Destructor
+    ~EnergyFilterStackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*);
+    virtual void NewStage();
+    virtual void PrepareNewEvent();
+
+  private:
+    G4bool first_stage_; ///< Is the first stage of the event being tracked?
+  };
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// nexus | ActionInitialization.cc
+//
+// This class instantiates the primary generator and the user actions
+// chosen in the configuration. In multithreaded mode, they are built once
+// per worker thread; only the run action exists in the master thread.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ActionInitialization.h"
+
+#include "PrimaryGeneration.h"
+#include "PersistencyManagerBase.h"
+#include "FactoryBase.h"
+
+#include <G4VPrimaryGenerator.hh>
+#include <G4UserRunAction.hh>
+#include <G4UserEventAction.hh>
+#include <G4UserTrackingAction.hh>
+#include <G4UserSteppingAction.hh>
+#include <G4UserStackingAction.hh>
+#include <G4Threading.hh>
+
+using namespace nexus;
+using std::make_unique;
+
+
+namespace {
+  // Persistency manager of a worker thread. It is created before
+  // the user actions, since some of them configure it.
+  G4ThreadLocal std::unique_ptr<PersistencyManagerBase> worker_pm;
+}
+
+
+
+ActionInitialization::ActionInitialization(G4String gen_name, G4String pm_name,
+                                           G4String runact_name, G4String evtact_name,
+                                           G4String stkact_name, G4String trkact_name,
+                                           G4String stepact_name):
+  G4VUserActionInitialization(),
+  gen_name_(gen_name), pm_name_(pm_name),
+  runact_name_(runact_name), evtact_name_(evtact_name),
+  stkact_name_(stkact_name), trkact_name_(trkact_name),
+  stepact_name_(stepact_name)
+{
+}
+
+
+
+ActionInitialization::~ActionInitialization()
+{
+}
+
+
+
+void ActionInitialization::BuildForMaster() const
+{
+  if (runact_name_ != "") {
+    auto runact = ObjFactory<G4UserRunAction>::Instance().CreateObject(runact_name_);
+    SetUserAction(runact.release());
+  }
+}
+
+
+
+void ActionInitialization::Build() const
+{
+  // The persistency manager of the master thread is created by the app
+  if (!G4Threading::IsMasterThread() && !worker_pm) {
+    worker_pm = ObjFactory<PersistencyManagerBase>::Instance().CreateObject(pm_name_);
+  }
+
+  auto pg = make_unique<PrimaryGeneration>();
+  pg->SetGenerator(ObjFactory<G4VPrimaryGenerator>::Instance().CreateObject(gen_name_));
+  SetUserAction(pg.release());
+
+  if (runact_name_ != "") {
+    auto runact = ObjFactory<G4UserRunAction>::Instance().CreateObject(runact_name_);
+    SetUserAction(runact.release());
+  }
+
+  if (evtact_name_ != "") {
+    auto evtact = ObjFactory<G4UserEventAction>::Instance().CreateObject(evtact_name_);
+    SetUserAction(evtact.release());
+  }
+
+  if (stkact_name_ != "") {
+    auto stkact = ObjFactory<G4UserStackingAction>::Instance().CreateObject(stkact_name_);
+    SetUserAction(stkact.release());
+  }
+
+  if (trkact_name_ != "") {
+    auto trkact = ObjFactory<G4UserTrackingAction>::Instance().CreateObject(trkact_name_);
+    SetUserAction(trkact.release());
+  }
+
+  if (stepact_name_ != "") {
+    auto stepact = ObjFactory<G4UserSteppingAction>::Instance().CreateObject(stepact_name_);
+    SetUserAction(stepact.release());
+  }
+}
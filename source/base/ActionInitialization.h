@@ -0,0 +1,50 @@
+// ----------------------------------------------------------------------------
+// nexus | ActionInitialization.h
+//
+// This class instantiates the primary generator and the user actions
+// chosen in the configuration. In multithreaded mode, they are built once
+// per worker thread; only the run action exists in the master thread.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ACTION_INITIALIZATION_H
+#define ACTION_INITIALIZATION_H
+
+#include <G4VUserActionInitialization.hh>
+#include <globals.hh>
+
+
+namespace nexus {
+
+  class ActionInitialization: public G4VUserActionInitialization
+  {
+  public:
+    /// Constructor taking the names the classes were registered with
+    /// in the factory. Empty names are skipped.
+    ActionInitialization(G4String gen_name, G4String pm_name,
+                         G4String runact_name, G4String evtact_name,
+                         G4String stkact_name, G4String trkact_name,
+                         G4String stepact_name);
+    /// Destructor
+    ~ActionInitialization();
+
+    /// Build the user actions of the master thread
+    virtual void BuildForMaster() const;
+    /// Build the primary generator and user actions of a worker thread
+    /// (or of the only thread, in sequential mode)
+    virtual void Build() const;
+
+  private:
+    G4String gen_name_;     ///< Name of the chosen primary generator
+    G4String pm_name_;      ///< Name of the chosen persistency manager
+    G4String runact_name_;  ///< Name of the chosen run action
+    G4String evtact_name_;  ///< Name of the chosen event action
+    G4String stkact_name_;  ///< Name of the chosen stacking action
+    G4String trkact_name_;  ///< Name of the chosen tracking action
+    G4String stepact_name_; ///< Name of the chosen stepping action
+  };
+
+} // end namespace nexus
+
+#endif
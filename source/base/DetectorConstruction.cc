@@ -15,6 +15,12 @@
 #include <G4LogicalVolume.hh>
 #include <G4VisAttributes.hh>
 #include <G4PVPlacement.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4SDManager.hh>
+#include <G4VSensitiveDetector.hh>
+#include <G4Threading.hh>
+
+#include <map>
 
 
 using namespace nexus;
@@ -75,6 +81,30 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 }
 
 
+void DetectorConstruction::ConstructSDandField()
+{
+  // The geometries create and attach their sensitive detectors in
+  // Construct(), which only runs in the master thread
+  if (G4Threading::IsMasterThread()) return;
+
+  // One clone per sensitive detector of the master, shared by all
+  // the volumes the original is attached to
+  std::map<G4VSensitiveDetector*, G4VSensitiveDetector*> clones;
+
+  for (auto lv: *G4LogicalVolumeStore::GetInstance()) {
+    G4VSensitiveDetector* master_sd = lv->GetMasterSensitiveDetector();
+    if (!master_sd) continue;
+
+    G4VSensitiveDetector*& sd = clones[master_sd];
+    if (!sd) {
+      sd = master_sd->Clone();
+      G4SDManager::GetSDMpointer()->AddNewDetector(sd);
+    }
+    SetSensitiveDetector(lv, sd);
+  }
+}
+
+
 void DetectorConstruction::SetGeometry(std::unique_ptr<GeometryBase> g)
 {
   geometry_ = std::move(g);
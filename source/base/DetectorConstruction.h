@@ -29,6 +29,11 @@ namespace nexus {
     /// It returns the physical volume that represents the world.
     virtual G4VPhysicalVolume* Construct();
 
+    /// Invoked by the run manager in every thread. Worker threads
+    /// attach here their own copy of the sensitive detectors created
+    /// by the geometry in the master thread.
+    virtual void ConstructSDandField();
+
     /// Set a detector geometry
     void SetGeometry(std::unique_ptr<GeometryBase>);
     /// Get the detector geometry
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------------
+// nexus | EventArena.cc
+//
+// Per-thread bump allocator for the objects created during an event
+// (hits, trajectories and their points). Allocation just advances a
+// pointer within large memory blocks, and deallocation only counts the
+// objects still alive: once all of them are gone, which happens when
+// the event is deleted after being stored, the arena is rewound and
+// its blocks are reused by the next event. Every object records the
+// arena it comes from, so that it is released there even if it is
+// deleted by another thread (e.g. an event kept and deleted by the
+// master). Events kept alive longer only make the arena grow.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "EventArena.h"
+
+#include <G4Threading.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace nexus;
+
+
+namespace {
+  const size_t BLOCK_SIZE = 1 << 20;
+}
+
+
+EventArena& EventArena::Instance()
+{
+  static G4ThreadLocal EventArena* arena = nullptr;
+  if (!arena) arena = new EventArena();
+  return *arena;
+}
+
+
+
+EventArena::EventArena(): current_(0), offset_(0), nlive_(0)
+{
+}
+
+
+
+EventArena::~EventArena()
+{
+  for (auto& b: blocks_) std::free(b.data);
+}
+
+
+
+void EventArena::NextBlock(size_t size)
+{
+  // Look for the next block big enough, skipping the
+  // others, or add a new one at the end of the list
+  size_t next = blocks_.empty() ? 0 : current_ + 1;
+  while (next < blocks_.size() && blocks_[next].size < size) ++next;
+
+  if (next == blocks_.size()) {
+    size_t block_size = std::max(size, BLOCK_SIZE);
+    char* data = static_cast<char*>(std::malloc(block_size));
+    if (!data) throw std::bad_alloc();
+    blocks_.push_back({data, block_size});
+  }
+
+  current_ = next;
+  offset_  = 0;
+}
+
+
+
+size_t EventArena::GetCapacity() const
+{
+  size_t capacity = 0;
+  for (auto& b: blocks_) capacity += b.size;
+  return capacity;
+}
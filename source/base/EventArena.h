@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// nexus | EventArena.h
+//
+// Per-thread bump allocator for the objects created during an event
+// (hits, trajectories and their points). Allocation just advances a
+// pointer within large memory blocks, and deallocation only counts the
+// objects still alive: once all of them are gone, which happens when
+// the event is deleted after being stored, the arena is rewound and
+// its blocks are reused by the next event. Every object records the
+// arena it comes from, so that it is released there even if it is
+// deleted by another thread (e.g. an event kept and deleted by the
+// master). Events kept alive longer only make the arena grow.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EVENT_ARENA_H
+#define EVENT_ARENA_H
+
+#include <G4Types.hh>
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+
+namespace nexus {
+
+  class EventArena
+  {
+  public:
+    /// Returns the arena of the calling thread
+    static EventArena& Instance();
+
+    /// Returns memory for an object of the given size and alignment
+    void* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+    /// Releases an object allocated by any arena. Memory is only reused
+    /// once all the objects allocated in the arena have been released.
+    static void Deallocate(void*);
+
+    /// Number of objects allocated and not yet released
+    size_t GetNumberOfLiveObjects() const;
+    /// Total size of the memory blocks owned by the arena
+    size_t GetCapacity() const;
+
+  private:
+    EventArena();
+    ~EventArena();
+    EventArena(const EventArena&) = delete;
+    EventArena& operator=(const EventArena&) = delete;
+
+    /// Moves on to the next block, creating it if needed
+    void NextBlock(size_t size);
+
+  private:
+    struct Block {
+      char* data;
+      size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_;  ///< Index of the block in use
+    size_t offset_;   ///< First free byte in the block in use
+    /// Number of live objects, released from any thread
+    std::atomic<size_t> nlive_;
+  };
+
+
+  /// Standard allocator drawing from the event arena, so that
+  /// containers owned by per-event objects can use it too
+  template <typename T>
+  struct EventArenaAllocator
+  {
+    typedef T value_type;
+
+    EventArenaAllocator() = default;
+    template <typename U>
+    EventArenaAllocator(const EventArenaAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    { return static_cast<T*>(EventArena::Instance().Allocate(n*sizeof(T), alignof(T))); }
+
+    void deallocate(T* p, size_t)
+    { EventArena::Deallocate(p); }
+  };
+
+  template <typename T, typename U>
+  inline bool operator==(const EventArenaAllocator<T>&, const EventArenaAllocator<U>&)
+  { return true; }
+
+  template <typename T, typename U>
+  inline bool operator!=(const EventArenaAllocator<T>&, const EventArenaAllocator<U>&)
+  { return false; }
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void* EventArena::Allocate(size_t size, size_t align)
+  {
+    // The arena is rewound here, by its own thread, once the objects
+    // have been released, since the last one may be released by another
+    if (nlive_.load(std::memory_order_acquire) == 0) {
+      current_ = 0;
+      offset_  = 0;
+    }
+
+    // The object is preceded by a pointer to the arena
+    const size_t header = sizeof(EventArena*);
+    if (align < alignof(EventArena*)) align = alignof(EventArena*);
+
+    size_t start = (offset_ + header + align - 1) & ~(align - 1);
+    if (blocks_.empty() || start + size > blocks_[current_].size) {
+      NextBlock(size + header + align);
+      start = (offset_ + header + align - 1) & ~(align - 1);
+    }
+    offset_ = start + size;
+    nlive_.fetch_add(1, std::memory_order_relaxed);
+
+    char* object = blocks_[current_].data + start;
+    EventArena* owner = this;
+    std::memcpy(object - header, &owner, header);
+    return object;
+  }
+
+  inline void EventArena::Deallocate(void* object)
+  {
+    if (!object) return;
+    EventArena* owner;
+    std::memcpy(&owner, static_cast<char*>(object) - sizeof(EventArena*),
+                sizeof(EventArena*));
+    owner->nlive_.fetch_sub(1, std::memory_order_release);
+  }
+
+  inline size_t EventArena::GetNumberOfLiveObjects() const
+  { return nlive_.load(std::memory_order_relaxed); }
+
+} // namespace nexus
+
+#endif
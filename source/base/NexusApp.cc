@@ -13,10 +13,11 @@
 #include "BatchSession.h"
 #include "GeometryBase.h"
 #include "DetectorConstruction.h"
-#include "PrimaryGeneration.h"
+#include "ActionInitialization.h"
 #include "FactoryBase.h"
 
 #include <G4GenericPhysicsList.hh>
+#include <G4RunManagerFactory.hh>
 #include <G4UImanager.hh>
 #include <G4StateManager.hh>
 #include <G4VPrimaryGenerator.hh>
@@ -32,12 +33,21 @@ using std::make_unique;
 using std::unique_ptr;
 
 
-NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
-                                         geo_name_(""), pm_name_(""),
-                                         runact_name_(""), evtact_name_(""),
-                                         stepact_name_(""), trkact_name_(""),
-                                         stkact_name_("")
+NexusApp::NexusApp(G4String init_macro, G4int nthreads): gen_name_(""),
+                                                         geo_name_(""), pm_name_(""),
+                                                         runact_name_(""), evtact_name_(""),
+                                                         stepact_name_(""), trkact_name_(""),
+                                                         stkact_name_("")
 {
+  // Create the run manager. Worker threads share the geometry and
+  // the physics tables built in the master thread.
+  if (nthreads > 0) {
+    run_mgr_.reset(G4RunManagerFactory::CreateRunManager(G4RunManagerType::Tasking,
+                                                         nthreads));
+  } else {
+    run_mgr_.reset(G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial));
+  }
+
   // Create and configure a generic messenger for the app
   msg_ = make_unique<G4GenericMessenger>(this, "/nexus/", "Nexus control commands.");
 
@@ -87,7 +97,7 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   BatchSession(init_macro.c_str()).SessionStart();
 
   // Set the physics list in the run manager
-  this->SetUserInitialization(pl.release());
+  run_mgr_->SetUserInitialization(pl.release());
 
   // Set the detector construction instance in the run manager
   auto dc = make_unique<DetectorConstruction>();
@@ -95,15 +105,11 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
     G4Exception("[NexusApp]", "NexusApp()", FatalException, "A geometry must be specified.");
   }
   dc->SetGeometry(ObjFactory<GeometryBase>::Instance().CreateObject(geo_name_));
-  this->SetUserInitialization(dc.release());
+  run_mgr_->SetUserInitialization(dc.release());
 
-  // Set the primary generation instance in the run manager
-  auto pg = make_unique<PrimaryGeneration>();
   if (gen_name_ == "") {
     G4Exception("[NexusApp]", "NexusApp()", FatalException, "A generator must be specified.");
   }
-  pg->SetGenerator(ObjFactory<G4VPrimaryGenerator>::Instance().CreateObject(gen_name_));
-  this->SetUserAction(pg.release());
 
   if (pm_name_ == "") {
     G4Exception("[NexusApp]", "NexusApp()", FatalException, "A persistency manager must be specified.");
@@ -113,31 +119,25 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
 
  // PersistencyManager::Initialize(init_macro, macros_, delayed_);
 
-  // Set the user action instances, if any, in the run manager
-  if (runact_name_ != "") {
-    auto runact = ObjFactory<G4UserRunAction>::Instance().CreateObject(runact_name_);
-    this->SetUserAction(runact.release());
-  }
-
-  if (evtact_name_ != "") {
-    auto evtact = ObjFactory<G4UserEventAction>::Instance().CreateObject(evtact_name_);
-    this->SetUserAction(evtact.release());
-  }
-
-  if (stkact_name_ != "") {
-    auto stkact = ObjFactory<G4UserStackingAction>::Instance().CreateObject(stkact_name_);
-    this->SetUserAction(stkact.release());
-  }
-
-  if (trkact_name_ != "") {
-    auto trkact = ObjFactory<G4UserTrackingAction>::Instance().CreateObject(trkact_name_);
-    this->SetUserAction(trkact.release());
+  if (nthreads > 0) {
+    master_gen_ = ObjFactory<G4VPrimaryGenerator>::Instance().CreateObject(gen_name_);
+    if (evtact_name_ != "")
+      master_evtact_ = ObjFactory<G4UserEventAction>::Instance().CreateObject(evtact_name_);
+    if (stkact_name_ != "")
+      master_stkact_ = ObjFactory<G4UserStackingAction>::Instance().CreateObject(stkact_name_);
+    if (trkact_name_ != "")
+      master_trkact_ = ObjFactory<G4UserTrackingAction>::Instance().CreateObject(trkact_name_);
+    if (stepact_name_ != "")
+      master_stepact_ = ObjFactory<G4UserSteppingAction>::Instance().CreateObject(stepact_name_);
   }
 
-  if (stepact_name_ != "") {
-    auto stepact = ObjFactory<G4UserSteppingAction>::Instance().CreateObject(stepact_name_);
-    this->SetUserAction(stepact.release());
-  }
+  // Set the primary generator and the user actions, if any, in the
+  // run manager. In sequential mode they are built right away.
+  auto ai = make_unique<ActionInitialization>(gen_name_, pm_name_,
+                                              runact_name_, evtact_name_,
+                                              stkact_name_, trkact_name_,
+                                              stepact_name_);
+  run_mgr_->SetUserInitialization(ai.release());
 
 
   /////////////////////////////////////////////////////////
@@ -184,7 +184,7 @@ void NexusApp::Initialize()
     ExecuteMacroFile(macros_[i].data());
   }
 
-  G4RunManager::Initialize();
+  run_mgr_->Initialize();
 
   for (unsigned int j=0; j<delayed_.size(); j++) {
     ExecuteMacroFile(delayed_[j].data());
@@ -199,6 +199,13 @@ void NexusApp::Initialize()
 
 
 
+void NexusApp::BeamOn(G4int nevents)
+{
+  run_mgr_->BeamOn(nevents);
+}
+
+
+
 void NexusApp::ExecuteMacroFile(const char* filename)
 {
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -1,8 +1,9 @@
 // ----------------------------------------------------------------------------
 // nexus | NexusApp.h
 //
-// This class is the run manager of the nexus simulation. It takes care of
-// setting up the simulation (geometry, physics lists, generators, actions),
+// This class is the application of the nexus simulation. It creates the
+// run manager (sequential or multithreaded) and takes care of setting up
+// the simulation (geometry, physics lists, generators, actions),
 // so that it is ready to be run.
 //
 // The NEXT Collaboration
@@ -16,22 +17,28 @@
 #include <G4RunManager.hh>
 
 class G4GenericMessenger;
+class G4VPrimaryGenerator;
+class G4UserEventAction;
+class G4UserStackingAction;
+class G4UserTrackingAction;
+class G4UserSteppingAction;
 
 
 namespace nexus {
 
-  class NexusApp: public G4RunManager
+  class NexusApp
   {
   public:
-    /// Constructor
-    NexusApp(G4String init_macro);
+    /// Constructor. Events are processed in nthreads worker threads,
+    /// or sequentially in the main thread if nthreads is 0.
+    NexusApp(G4String init_macro, G4int nthreads=0);
     /// Destructor
     ~NexusApp();
 
-    virtual void Initialize();
+    void Initialize();
 
-    /// Returns the number of events to be processed in the current run
-    G4int GetNumberOfEventsToBeProcessed() const;
+    /// Process the given number of events
+    void BeamOn(G4int nevents);
 
   private:
     void RegisterMacro(G4String);
@@ -45,6 +52,8 @@ namespace nexus {
     void SetRandomSeed(G4int);
 
   private:
+    std::unique_ptr<G4RunManager> run_mgr_;
+
     std::unique_ptr<G4GenericMessenger> msg_;
     G4String gen_name_; ///< Name of the chosen primary generator
     G4String geo_name_;  ///< Name of the chosen geometry
@@ -60,13 +69,17 @@ namespace nexus {
 
     std::unique_ptr<PersistencyManagerBase> pm_;
 
+    // In multithreaded mode the generator and the user actions are built
+    // in the worker threads. These instances live in the master thread
+    // only so that their configuration commands exist when the macros
+    // are processed.
+    std::unique_ptr<G4VPrimaryGenerator>  master_gen_;
+    std::unique_ptr<G4UserEventAction>    master_evtact_;
+    std::unique_ptr<G4UserStackingAction> master_stkact_;
+    std::unique_ptr<G4UserTrackingAction> master_trkact_;
+    std::unique_ptr<G4UserSteppingAction> master_stepact_;
   };
 
-  // INLINE DEFINITIONS ////////////////////////////////////
-
-  inline G4int NexusApp::GetNumberOfEventsToBeProcessed() const
-  { return numberOfEventToBeProcessed; }
-
 } // namespace nexus
 
 #endif
@@ -17,36 +17,43 @@
 #include <G4ParticleDefinition.hh>
 #include <G4VProcess.hh>
 
+#include <unordered_set>
+
 using namespace nexus;
 
 
-G4Allocator<Trajectory> TrjAllocator;
+const G4String* Trajectory::Intern(const G4String& name)
+{
+  static G4ThreadLocal std::unordered_set<G4String>* names = nullptr;
+  if (!names) names = new std::unordered_set<G4String>();
+  return &*(names->insert(name).first);
+}
 
 
 Trajectory::Trajectory(const G4Track* track):
   G4VTrajectory(), pdef_(0), trackId_(-1), parentId_(-1),
   initial_time_(0.), final_time_(0), length_(0.), edep_(0.),
-  record_trjpoints_(true), trjpoints_(0)
+  record_trjpoints_(true)
 {
   pdef_     = track->GetDefinition();
   trackId_  = track->GetTrackID();
   parentId_ = track->GetParentID();
 
   if (parentId_ == 0)
-    creator_process_ = "none";
+    creator_process_ = Intern("none");
   else
-    creator_process_ = track->GetCreatorProcess()->GetProcessName();
+    creator_process_ = Intern(track->GetCreatorProcess()->GetProcessName());
 
   initial_momentum_ = track->GetMomentum();
   initial_position_ = track->GetVertexPosition();
   initial_time_ = track->GetGlobalTime();
-  initial_volume_ = track->GetVolume()->GetName();
+  initial_volume_ = Intern(track->GetVolume()->GetName());
+  final_volume_ = final_process_ = Intern("");
 
-  trjpoints_ = new TrajectoryPointContainer();
   TrajectoryPoint* first_trj_point = 
                 new TrajectoryPoint(track->GetPosition(), 
                                     track->GetGlobalTime());
-  trjpoints_->push_back(first_trj_point);
+  trjpoints_.push_back(first_trj_point);
 
   // Add this trajectory in the map, but only if no other
   // trajectory for this track id has been registered yet
@@ -59,16 +66,16 @@ Trajectory::Trajectory(const G4Track* track):
 Trajectory::Trajectory(const Trajectory& other): G4VTrajectory()
 {
   pdef_ = other.pdef_;
+  creator_process_ = final_process_ = Intern("");
+  initial_volume_ = final_volume_ = Intern("");
 }
 
 
 
 Trajectory::~Trajectory()
 {
-  for (unsigned int i=0; i<trjpoints_->size(); ++i)
-    delete (*trjpoints_)[i];
-  trjpoints_->clear();
-  delete trjpoints_;
+  for (unsigned int i=0; i<trjpoints_.size(); ++i)
+    delete trjpoints_[i];
 }
 
 
@@ -101,7 +108,7 @@ void Trajectory::AppendStep(const G4Step* step)
   TrajectoryPoint* point =
     new TrajectoryPoint(step->GetPostStepPoint()->GetPosition(),
                         step->GetPostStepPoint()->GetGlobalTime());
-  trjpoints_->push_back(point);
+  trjpoints_.push_back(point);
 }
 
 
@@ -117,11 +124,11 @@ void Trajectory::MergeTrajectory(G4VTrajectory* second)
 
   // initial point of the second trajectory should not be merged
   for (G4int i=1; i<entries ; ++i) {
-    trjpoints_->push_back((*(tmp->trjpoints_))[i]);
+    trjpoints_.push_back(tmp->trjpoints_[i]);
   }
 
-  delete (*tmp->trjpoints_)[0];
-  tmp->trjpoints_->clear();
+  delete tmp->trjpoints_[0];
+  tmp->trjpoints_.clear();
 }
 
 
@@ -12,7 +12,9 @@
 #define TRAJECTORY_H
 
 #include <G4VTrajectory.hh>
-#include <G4Allocator.hh>
+#include "EventArena.h"
+
+#include <vector>
 
 class G4Track;
 class G4ParticleDefinition;
@@ -21,7 +23,8 @@ class G4VTrajectoryPoint;
 
 namespace nexus {
 
-  typedef std::vector<G4VTrajectoryPoint*> TrajectoryPointContainer;
+  typedef std::vector<G4VTrajectoryPoint*,
+                      EventArenaAllocator<G4VTrajectoryPoint*> > TrajectoryPointContainer;
 
   class Trajectory: public G4VTrajectory
   {
@@ -114,6 +117,11 @@ namespace nexus {
     /// only be constructed associated to a track.
     Trajectory();
 
+    /// Returns a copy of the string shared by all the trajectories of
+    /// the thread. Volume and process names come from a small set,
+    /// so they are stored only once.
+    static const G4String* Intern(const G4String&);
+
 
   private:
     G4ParticleDefinition* pdef_; //< Pointer to the particle definition
@@ -133,44 +141,37 @@ namespace nexus {
     G4double length_;
     G4double edep_;
 
-    G4String creator_process_;
-    G4String final_process_;
+    const G4String* creator_process_;
+    const G4String* final_process_;
 
-    G4String initial_volume_;
-    G4String final_volume_;
+    const G4String* initial_volume_;
+    const G4String* final_volume_;
 
     G4bool record_trjpoints_;
 
-    TrajectoryPointContainer* trjpoints_;
+    TrajectoryPointContainer trjpoints_;
 
 };
 
 } // namespace nexus
 
 
-#if defined G4TRACKING_ALLOC_EXPORT
-extern G4DLLEXPORT G4Allocator<nexus::Trajectory> TrjAllocator;
-#else
-extern G4DLLIMPORT G4Allocator<nexus::Trajectory> TrjAllocator;
-#endif
-
-
 // INLINE DEFINITIONS //////////////////////////////////////////////
 
-inline void* nexus::Trajectory::operator new(size_t)
-{ return ((void*) TrjAllocator.MallocSingle()); }
+inline void* nexus::Trajectory::operator new(size_t size)
+{ return nexus::EventArena::Instance().Allocate(size, alignof(nexus::Trajectory)); }
 
 inline void nexus::Trajectory::operator delete(void* trj)
-{ TrjAllocator.FreeSingle((nexus::Trajectory*) trj); }
+{ nexus::EventArena::Deallocate(trj); }
 
 inline G4ParticleDefinition* nexus::Trajectory::GetParticleDefinition()
 { return pdef_; }
 
 inline int nexus::Trajectory::GetPointEntries() const
-{ return trjpoints_->size(); }
+{ return trjpoints_.size(); }
 
 inline G4VTrajectoryPoint* nexus::Trajectory::GetPoint(G4int i) const
-{ return (*trjpoints_)[i]; }
+{ return trjpoints_[i]; }
 
 inline G4ThreeVector nexus::Trajectory::GetInitialMomentum() const
 { return initial_momentum_; }
@@ -214,21 +215,21 @@ inline G4double nexus::Trajectory::GetEnergyDeposit() const { return edep_; }
 inline void nexus::Trajectory::SetEnergyDeposit(G4double e) { edep_ = e; }
 
 inline G4String nexus::Trajectory::GetCreatorProcess() const
-{ return creator_process_; }
+{ return *creator_process_; }
 
 inline G4String nexus::Trajectory::GetFinalProcess() const
-{ return final_process_; }
+{ return *final_process_; }
 
 inline void nexus::Trajectory::SetFinalProcess(G4String fp)
-{ final_process_ = fp; }
+{ final_process_ = Intern(fp); }
 
 inline G4String nexus::Trajectory::GetInitialVolume() const
-{ return initial_volume_; }
+{ return *initial_volume_; }
 
 inline G4String nexus::Trajectory::GetFinalVolume() const
-{ return final_volume_; }
+{ return *final_volume_; }
 
 inline void nexus::Trajectory::SetFinalVolume(G4String fv)
-{ final_volume_ = fv; }
+{ final_volume_ = Intern(fv); }
 
 #endif
@@ -11,7 +11,7 @@
 #include <G4VTrajectory.hh>
 
 
-std::map<int, G4VTrajectory*> nexus::TrajectoryMap::map_;
+G4ThreadLocal std::map<int, G4VTrajectory*> nexus::TrajectoryMap::map_;
 
 
 namespace nexus {
@@ -10,6 +10,7 @@
 #define TRAJECTORY_MAP_H
 
 #include <map>
+#include <G4Types.hh>
 
 class G4VTrajectory;
 
@@ -34,7 +35,8 @@ namespace nexus {
     ~TrajectoryMap();
 
   private:
-    static std::map<int, G4VTrajectory*> map_;
+    // Each thread tracks its own events, so it keeps its own map
+    static G4ThreadLocal std::map<int, G4VTrajectory*> map_;
   };
 
 } // namespace nexus
@@ -12,9 +12,6 @@
 using namespace nexus;
 
 
-G4Allocator<TrajectoryPoint> TrjPointAllocator;
-
-
 TrajectoryPoint::TrajectoryPoint(): 
   position_(0.,0.,0.), time_(0.)
 {
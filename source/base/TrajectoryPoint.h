@@ -11,7 +11,7 @@
 #define TRAJECTORY_POINT_H
 
 #include <G4VTrajectoryPoint.hh>
-#include <G4Allocator.hh>
+#include "EventArena.h"
 
 
 namespace nexus {
@@ -51,12 +51,6 @@ namespace nexus {
 
 } // namespace nexus
 
-#if defined G4TRACKING_ALLOC_EXPORT
-extern G4DLLEXPORT G4Allocator<nexus::TrajectoryPoint> TrjPointAllocator;
-#else
-extern G4DLLIMPORT G4Allocator<nexus::TrajectoryPoint> TrjPointAllocator;
-#endif
-
 // INLINE DEFINITIONS //////////////////////////////////////
 
 namespace nexus {
@@ -64,11 +58,11 @@ namespace nexus {
   inline int TrajectoryPoint::operator ==(const TrajectoryPoint& other) const
   {return (this==&other); }
 
-  inline void* TrajectoryPoint::operator new(size_t)
-  { return ((void*) TrjPointAllocator.MallocSingle()); }
+  inline void* TrajectoryPoint::operator new(size_t size)
+  { return EventArena::Instance().Allocate(size, alignof(TrajectoryPoint)); }
 
   inline void TrajectoryPoint::operator delete(void* tp)
-  { TrjPointAllocator.FreeSingle((TrajectoryPoint*) tp); }
+  { EventArena::Deallocate(tp); }
 
   inline const G4ThreeVector TrajectoryPoint::GetPosition() const
   { return position_; }
@@ -0,0 +1,403 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0EnergyTable.cc
+//
+// This class is a sampler of the energies of the two electrons (or
+// positrons) of a double beta decay, tabulated once for a decay mode
+// and a window of the energy sum. The energy of the first particle is
+// chosen from a table of bins with Walker's alias method, and, if the
+// second energy is not fixed by the first one, it is chosen in the same
+// way from a table of its bins for the bin of the first energy. Tables
+// are shared by the threads using the same key, and can be saved to a
+// file to be loaded instead of being built again.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Decay0EnergyTable.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#include <unistd.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  /// Header of the table files, followed by the key and the arrays
+  /// of the table. Numbers use the native byte order.
+  struct Decay0TableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t dimensions;
+    uint64_t key_size;
+    double bin_width;
+    double e_min, e_low, e_high;
+    double sum_low, sum_high;
+    uint64_t num_rows;
+    uint64_t num_cells;
+  };
+
+  const char DECAY0_TABLE_MAGIC[8] = {'N','X','D','C','Y','0','T','B'};
+  const uint32_t DECAY0_TABLE_VERSION = 1;
+
+  /// Maximum number of cells drawn to find energies in the window
+  const G4int MAX_DRAWS = 1000000;
+
+  /// Only one thread builds or loads a table at a time, so that
+  /// the others find it already in memory
+  std::mutex table_mutex;
+  std::map<std::string, std::weak_ptr<const Decay0EnergyTable>> tables;
+
+  /// Walker's alias method: fills the probability of keeping each
+  /// entry and the entry chosen otherwise, for positive weights
+  void BuildAliasTable(const G4double* weights, size_t n,
+                       float* prob, uint32_t* alias)
+  {
+    G4double total = 0.;
+    for (size_t i=0; i<n; ++i) total += weights[i];
+
+    std::vector<G4double> p(n);
+    std::vector<size_t> small, large;
+    for (size_t i=0; i<n; ++i) {
+      prob[i]  = 1.;
+      alias[i] = i;
+      p[i] = weights[i] * n / total;
+      if (p[i] < 1.) small.push_back(i);
+      else           large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(); small.pop_back();
+      size_t l = large.back();
+      prob[s]  = p[s];
+      alias[s] = l;
+      p[l] -= 1. - p[s];
+      if (p[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+  }
+
+  template <typename T>
+  void ReadArray(std::ifstream& file, std::vector<T>& v, size_t n)
+  {
+    v.resize(n);
+    file.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+  }
+
+  template <typename T>
+  void WriteArray(std::ofstream& file, const std::vector<T>& v)
+  {
+    file.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+  }
+
+}
+
+
+
+Decay0EnergyTable::Decay0EnergyTable():
+  bin_width_(0.), e_min_(0.), e_low_(0.), e_high_(0.),
+  sum_low_(0.), sum_high_(0.)
+{
+}
+
+
+
+Decay0EnergyTable::~Decay0EnergyTable()
+{
+}
+
+
+
+void Decay0EnergyTable::Build(const std::vector<G4double>& weights,
+                              G4double e_min, G4double bin_width,
+                              G4double e_low, G4double e_high)
+{
+  bin_width_ = bin_width;
+  e_min_  = e_min;
+  e_low_  = e_low;
+  e_high_ = e_high;
+  sum_low_ = sum_high_ = 0.;
+
+  row_bin_.clear();
+  col_first_.clear();
+  col_offset_.clear();
+  cell_prob_.clear();
+  cell_alias_.clear();
+
+  // The weight of the bins partly outside the limits
+  // is reduced in proportion to the part inside
+  std::vector<G4double> row_weights;
+  for (size_t i=0; i<weights.size(); ++i) {
+    G4double low  = std::max(e_low,  e_min + i * bin_width);
+    G4double high = std::min(e_high, e_min + (i+1) * bin_width);
+    G4double weight = weights[i] * (high - low) / bin_width;
+    if (high > low && weight > 0.) {
+      row_bin_.push_back(i);
+      row_weights.push_back(weight);
+    }
+  }
+
+  row_prob_.resize(row_bin_.size());
+  row_alias_.resize(row_bin_.size());
+  BuildAliasTable(row_weights.data(), row_weights.size(),
+                  row_prob_.data(), row_alias_.data());
+}
+
+
+
+void Decay0EnergyTable::Build(const Density& density, G4double bin_width,
+                              G4double sum_low, G4double sum_high)
+{
+  bin_width_ = bin_width;
+  e_min_  = 0.;
+  e_low_  = 0.;
+  e_high_ = sum_high;
+  sum_low_  = sum_low;
+  sum_high_ = sum_high;
+
+  row_bin_.clear();
+  col_first_.clear();
+  col_offset_.assign(1, 0);
+  cell_prob_.clear();
+  cell_alias_.clear();
+
+  // Cell (i,j) covers [i,i+1)x[j,j+1) bins and has some sum of the
+  // energies in the window if i+j < sum_high and i+j+2 > sum_low,
+  // in bins. The density is taken at its center.
+  //
+  // This biases the sampled distribution, which is constant in each
+  // cell. For the cells inside the window, their weight is that of the
+  // midpoint rule, with a relative error of order bin_width^2 times the
+  // second derivatives of the log of the density (about 1.e-6 for cells
+  // of 1 keV and energies of MeV, away from the endpoint). The part
+  // inside the window of a cell crossed by its limits keeps the density
+  // at the center, with a relative error of order bin_width in a
+  // fraction of order bin_width / (sum_high - sum_low) of the cells.
+  // At the endpoint of the spectrum, where the density vanishes as a
+  // power of the distance to it, this error is larger in relative
+  // terms, but the last cells hold a negligible part of the
+  // probability (of order (bin_width / (e0 - sum_low))^6 for the
+  // two-neutrino modes).
+  const G4int num_rows = std::ceil(sum_high / bin_width);
+  const G4int last_sum = std::ceil(sum_high / bin_width);
+  const G4int first_sum = std::floor(sum_low / bin_width) - 1;
+
+  std::vector<G4double> row_weights;
+  std::vector<G4double> cells;
+
+  for (G4int i=0; i<num_rows; ++i) {
+    const G4int first = std::max(first_sum - i, 0);
+    const G4int last = last_sum - i;
+    if (last <= first) continue;
+
+    const G4double e1 = (i + .5) * bin_width;
+    G4double total = 0.;
+    cells.resize(last - first);
+    for (G4int j=first; j<last; ++j) {
+      cells[j-first] = std::max(density(e1, (j + .5) * bin_width), 0.);
+      total += cells[j-first];
+    }
+    if (!(total > 0.)) continue;
+
+    const size_t offset = cell_prob_.size();
+    cell_prob_.resize(offset + cells.size());
+    cell_alias_.resize(offset + cells.size());
+    BuildAliasTable(cells.data(), cells.size(),
+                    &cell_prob_[offset], &cell_alias_[offset]);
+
+    row_bin_.push_back(i);
+    row_weights.push_back(total);
+    col_first_.push_back(first);
+    col_offset_.push_back(cell_prob_.size());
+  }
+
+  row_prob_.resize(row_bin_.size());
+  row_alias_.resize(row_bin_.size());
+  BuildAliasTable(row_weights.data(), row_weights.size(),
+                  row_prob_.data(), row_alias_.data());
+}
+
+
+
+G4double Decay0EnergyTable::Shoot() const
+{
+  const uint32_t i = row_bin_[ShootRow()];
+  G4double low  = std::max(e_low_,  e_min_ + i * bin_width_);
+  G4double high = std::min(e_high_, e_min_ + (i+1) * bin_width_);
+  return low + (high - low) * G4UniformRand();
+}
+
+
+
+G4bool Decay0EnergyTable::Shoot(G4double& e1, G4double& e2) const
+{
+  // Points are uniform in the cells, which are chosen with a weight
+  // proportional to the density at their center and their full area.
+  // Points of the cells crossed by the limits of the window that fall
+  // outside are discarded, and a new cell is chosen.
+  for (G4int n_draws=0; n_draws<MAX_DRAWS; ++n_draws) {
+    const size_t row = ShootRow();
+    e1 = (row_bin_[row] + G4UniformRand()) * bin_width_;
+
+    const uint32_t offset = col_offset_[row];
+    const uint32_t n = col_offset_[row+1] - offset;
+    G4double u = G4UniformRand() * n;
+    uint32_t j = std::min(uint32_t(u), n - 1);
+    if (u - j >= cell_prob_[offset+j]) j = cell_alias_[offset+j];
+    e2 = (col_first_[row] + j + G4UniformRand()) * bin_width_;
+
+    const G4double sum = e1 + e2;
+    if (sum >= sum_low_ && sum <= sum_high_) return true;
+  }
+
+  // Only possible if all the cells with some weight lie almost
+  // entirely outside the window, which is narrower than a cell
+  G4String msg = "No energies in the window of the sum [" +
+    std::to_string(sum_low_) + ", " + std::to_string(sum_high_) +
+    "] after " + std::to_string(MAX_DRAWS) + " draws.";
+  G4Exception("[Decay0EnergyTable]", "Shoot()", JustWarning, msg);
+  return false;
+}
+
+
+
+G4bool Decay0EnergyTable::Load(const G4String& filename, const std::string& key)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) return false;
+
+  Decay0TableHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  if (!file ||
+      std::memcmp(header.magic, DECAY0_TABLE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != DECAY0_TABLE_VERSION ||
+      (header.dimensions != 1 && header.dimensions != 2) ||
+      header.key_size != key.size()) return false;
+
+  std::string file_key(key.size(), ' ');
+  file.read(&file_key[0], file_key.size());
+  if (!file || file_key != key) return false;
+
+  const size_t num_rows = header.num_rows;
+  ReadArray(file, row_bin_, num_rows);
+  ReadArray(file, row_prob_, num_rows);
+  ReadArray(file, row_alias_, num_rows);
+
+  col_first_.clear();
+  col_offset_.clear();
+  cell_prob_.clear();
+  cell_alias_.clear();
+
+  if (header.dimensions == 2) {
+    ReadArray(file, col_first_, num_rows);
+    ReadArray(file, col_offset_, num_rows + 1);
+    ReadArray(file, cell_prob_, header.num_cells);
+    ReadArray(file, cell_alias_, header.num_cells);
+  }
+
+  // A damaged table must not send the sampling out of the arrays
+  G4bool valid = bool(file);
+  for (size_t i=0; valid && i<num_rows; ++i)
+    valid = row_alias_[i] < num_rows;
+
+  if (valid && header.dimensions == 2) {
+    valid = col_offset_[0] == 0 && col_offset_[num_rows] == header.num_cells;
+    for (size_t i=0; valid && i<num_rows; ++i) {
+      const uint32_t n = col_offset_[i+1] - col_offset_[i];
+      valid = col_offset_[i+1] > col_offset_[i];
+      for (uint32_t j=col_offset_[i]; valid && j<col_offset_[i+1]; ++j)
+        valid = cell_alias_[j] < n;
+    }
+  }
+
+  if (!valid) {
+    row_bin_.clear();
+    col_offset_.clear();
+    return false;
+  }
+
+  bin_width_ = header.bin_width;
+  e_min_     = header.e_min;
+  e_low_     = header.e_low;
+  e_high_    = header.e_high;
+  sum_low_   = header.sum_low;
+  sum_high_  = header.sum_high;
+
+  return true;
+}
+
+
+
+void Decay0EnergyTable::Save(const G4String& filename, const std::string& key) const
+{
+  Decay0TableHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, DECAY0_TABLE_MAGIC, sizeof(header.magic));
+  header.version    = DECAY0_TABLE_VERSION;
+  header.dimensions = HasSecondEnergy() ? 2 : 1;
+  header.key_size   = key.size();
+  header.bin_width  = bin_width_;
+  header.e_min      = e_min_;
+  header.e_low      = e_low_;
+  header.e_high     = e_high_;
+  header.sum_low    = sum_low_;
+  header.sum_high   = sum_high_;
+  header.num_rows   = row_bin_.size();
+  header.num_cells  = cell_prob_.size();
+
+  // The table is written under a temporary name and renamed, so that
+  // other jobs never see it incomplete. If the directory is not writable
+  // the table is just built again the next time.
+  G4String tmp_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+
+  std::ofstream file(tmp_filename, std::ios::binary);
+  if (!file.is_open()) return;
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(key.data(), key.size());
+  WriteArray(file, row_bin_);
+  WriteArray(file, row_prob_);
+  WriteArray(file, row_alias_);
+  if (HasSecondEnergy()) {
+    WriteArray(file, col_first_);
+    WriteArray(file, col_offset_);
+    WriteArray(file, cell_prob_);
+    WriteArray(file, cell_alias_);
+  }
+  file.close();
+
+  if (!file || std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    std::remove(tmp_filename.c_str());
+}
+
+
+
+std::shared_ptr<const Decay0EnergyTable>
+Decay0EnergyTable::Get(const std::string& key, const G4String& filename,
+                       const std::function<void(Decay0EnergyTable&)>& build)
+{
+  std::lock_guard<std::mutex> lock(table_mutex);
+
+  std::shared_ptr<const Decay0EnergyTable> table = tables[key].lock();
+  if (table) return table;
+
+  std::shared_ptr<Decay0EnergyTable> new_table =
+    std::make_shared<Decay0EnergyTable>();
+
+  if (filename.empty() || !new_table->Load(filename, key)) {
+    build(*new_table);
+    if (!filename.empty()) new_table->Save(filename, key);
+  }
+
+  tables[key] = new_table;
+  return new_table;
+}
@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0EnergyTable.h
+//
+// This class is a sampler of the energies of the two electrons (or
+// positrons) of a double beta decay, tabulated once for a decay mode
+// and a window of the energy sum. The energy of the first particle is
+// chosen from a table of bins with Walker's alias method, and, if the
+// second energy is not fixed by the first one, it is chosen in the same
+// way from a table of its bins for the bin of the first energy. Tables
+// are shared by the threads using the same key, and can be saved to a
+// file to be loaded instead of being built again.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DECAY0_ENERGY_TABLE_H
+#define DECAY0_ENERGY_TABLE_H
+
+#include <globals.hh>
+#include <Randomize.hh>
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+
+namespace nexus {
+
+  class Decay0EnergyTable
+  {
+  public:
+    /// Two-dimensional density of the energies of the two particles
+    typedef std::function<G4double(G4double, G4double)> Density;
+
+    /// Constructor. The table is empty.
+    Decay0EnergyTable();
+    /// Destructor
+    ~Decay0EnergyTable();
+
+    /// Tabulates the energy of the first particle only. Bin i covers
+    /// [e_min + i*bin_width, e_min + (i+1)*bin_width) with the given
+    /// weight, and energies are restricted to [e_low, e_high).
+    void Build(const std::vector<G4double>& weights, G4double e_min,
+               G4double bin_width, G4double e_low, G4double e_high);
+
+    /// Tabulates the energies of both particles in square cells of
+    /// the given side starting at zero, restricted to a sum of the
+    /// energies in [sum_low, sum_high]
+    void Build(const Density& density, G4double bin_width,
+               G4double sum_low, G4double sum_high);
+
+    /// Returns true if no energies can be sampled
+    G4bool IsEmpty() const;
+
+    /// Returns true if the table has the energy of the second particle
+    G4bool HasSecondEnergy() const;
+
+    /// Generates the energy of the first particle (one-dimensional table)
+    G4double Shoot() const;
+
+    /// Generates the energies of both particles (two-dimensional table),
+    /// returning false if none were found in the window of the sum
+    G4bool Shoot(G4double& e1, G4double& e2) const;
+
+    /// Loads a table saved with the same key, returning false if the
+    /// file does not exist or does not match it
+    G4bool Load(const G4String& filename, const std::string& key);
+
+    /// Saves the table along with its key
+    void Save(const G4String& filename, const std::string& key) const;
+
+    /// Returns the table with the given key, shared by all the threads.
+    /// If no other thread has it, it is loaded from the file (unless
+    /// the filename is empty), or built with the function and saved.
+    static std::shared_ptr<const Decay0EnergyTable>
+    Get(const std::string& key, const G4String& filename,
+        const std::function<void(Decay0EnergyTable&)>& build);
+
+  private:
+    /// Chooses a bin of the first energy
+    size_t ShootRow() const;
+
+  private:
+    G4double bin_width_;
+    G4double e_min_;               ///< Lower edge of the bin 0 of the first energy
+    G4double e_low_, e_high_;      ///< Limits of the first energy
+    G4double sum_low_, sum_high_;  ///< Limits of the sum of both energies
+
+    // Bins of the first energy with a positive weight:
+    // index of the bin and alias table
+    std::vector<uint32_t> row_bin_;
+    std::vector<float> row_prob_;
+    std::vector<uint32_t> row_alias_;
+
+    // Bins of the second energy for each bin of the first one: first
+    // bin, position of the alias table of the row in the arrays of
+    // cells, and alias table, with aliases relative to the row
+    std::vector<uint32_t> col_first_;
+    std::vector<uint32_t> col_offset_;
+    std::vector<float> cell_prob_;
+    std::vector<uint32_t> cell_alias_;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline G4bool Decay0EnergyTable::IsEmpty() const
+  { return row_bin_.empty(); }
+
+  inline G4bool Decay0EnergyTable::HasSecondEnergy() const
+  { return !col_offset_.empty(); }
+
+  inline size_t Decay0EnergyTable::ShootRow() const
+  {
+    G4double u = G4UniformRand() * row_bin_.size();
+    size_t i = std::min(size_t(u), row_bin_.size() - 1);
+    if (u - i >= row_prob_[i]) i = row_alias_[i];
+    return i;
+  }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,293 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0FileReader.cc
+//
+// This class reads the events of an ascii file produced by the Decay0
+// (GENBB) event generator. The file is mapped into memory and an index
+// with the position of every event is built the first time it is opened,
+// and saved next to it to be loaded the following times. Any event can
+// then be read directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Decay0FileReader.h"
+
+#include <fstream>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <mutex>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  /// Header of the index files, followed by the position of
+  /// every event (uint64). Numbers use the native byte order.
+  struct Decay0IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t file_size;  // of the indexed file
+    int64_t mtime;       // of the indexed file, in ns
+    uint64_t num_events;
+  };
+
+  const char DECAY0_INDEX_MAGIC[8] = {'N','X','D','C','Y','0','I','X'};
+  const uint32_t DECAY0_INDEX_VERSION = 2;
+
+  /// Only one thread builds or loads an index at a time, so that
+  /// the others find it already saved
+  std::mutex index_mutex;
+
+  inline const char* SkipSpaces(const char* p, const char* end)
+  {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+  }
+
+  /// Parses the number starting at the next non-space character,
+  /// returning the position after it, or nullptr on failure.
+  /// Floating-point numbers are parsed with strtod, since
+  /// std::from_chars only supports them from GCC 11.
+  template <typename T>
+  inline const char* ParseNumber(const char* p, const char* end, T& value)
+  {
+    p = SkipSpaces(p, end);
+    if (p < end && *p == '+') ++p;
+
+    if constexpr (std::is_floating_point<T>::value) {
+      // The file is not null-terminated, so the number is copied first
+      char buffer[64];
+      size_t n = 0;
+      while (p + n < end && n < sizeof(buffer) - 1 &&
+             std::strchr("0123456789+-.eE", p[n]) && p[n] != '\0') {
+        buffer[n] = p[n];
+        ++n;
+      }
+      buffer[n] = '\0';
+      char* last;
+      value = std::strtod(buffer, &last);
+      return last != buffer ? p + (last - buffer) : nullptr;
+    }
+    else {
+      std::from_chars_result result = std::from_chars(p, end, value);
+      return result.ec == std::errc() ? result.ptr : nullptr;
+    }
+  }
+
+  inline const char* NextLine(const char* p, const char* end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return eol ? eol + 1 : end;
+  }
+}
+
+
+
+Decay0FileReader::Decay0FileReader():
+  data_(nullptr), size_(0), mtime_(0)
+{
+}
+
+
+
+Decay0FileReader::~Decay0FileReader()
+{
+  Close();
+}
+
+
+
+G4bool Decay0FileReader::Open(const G4String& filename)
+{
+  Close();
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0) return false;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  // Modification time in ns, since files rewritten within the same
+  // second would otherwise keep a stale index if their size is equal
+  size_  = st.st_size;
+#ifdef __APPLE__
+  mtime_ = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+  mtime_ = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+
+  void* addr = mmap(0, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return false;
+
+  data_ = static_cast<const char*>(addr);
+
+  std::lock_guard<std::mutex> lock(index_mutex);
+
+  G4String index_file = filename + ".idx";
+  if (!LoadIndex(index_file)) {
+    BuildIndex();
+    SaveIndex(index_file);
+  }
+
+  return true;
+}
+
+
+
+void Decay0FileReader::Close()
+{
+  if (data_) munmap(const_cast<char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  offsets_.clear();
+}
+
+
+
+G4bool Decay0FileReader::ReadEvent(size_t i, Decay0Event& event) const
+{
+  if (i >= offsets_.size()) return false;
+
+  const char* end = data_ + size_;
+  const char* p = data_ + offsets_[i];
+
+  G4int entries = 0;
+  p = ParseNumber(p, end, event.number);
+  if (p) p = ParseNumber(p, end, event.time);
+  if (p) p = ParseNumber(p, end, entries);
+
+  event.particles.resize(p ? entries : 0);
+
+  for (Decay0Particle& particle: event.particles) {
+    if (p) p = ParseNumber(p, end, particle.g3code);
+    if (p) p = ParseNumber(p, end, particle.px);
+    if (p) p = ParseNumber(p, end, particle.py);
+    if (p) p = ParseNumber(p, end, particle.pz);
+    if (p) p = ParseNumber(p, end, particle.time);
+  }
+
+  if (!p) {
+    G4String msg = "Malformed event " + std::to_string(i) + " in Decay0 file.";
+    G4Exception("[Decay0FileReader]", "ReadEvent()", FatalException, msg);
+  }
+
+  return true;
+}
+
+
+
+void Decay0FileReader::BuildIndex()
+{
+  const char* end = data_ + size_;
+
+  // The events start after the two lines following
+  // the one with the number of events
+  size_t pos = std::string_view(data_, size_).find("First event");
+  if (pos == std::string_view::npos) {
+    G4Exception("[Decay0FileReader]", "BuildIndex()", JustWarning,
+                "Decay0 file without header. No events will be read.");
+    return;
+  }
+
+  const char* p = data_ + pos;
+  for (G4int i=0; i<3; ++i) p = NextLine(p, end);
+
+  // Every event is a line with the event number, the time and the
+  // number of particles, followed by one line per particle
+  while (true) {
+    const char* start = SkipSpaces(p, end);
+    if (start == end) break;
+
+    G4long number;
+    G4double time;
+    G4int entries;
+    const char* q = ParseNumber(start, end, number);
+    if (q) q = ParseNumber(q, end, time);
+    if (q) q = ParseNumber(q, end, entries);
+    if (!q || entries < 0) break;
+
+    q = NextLine(q, end);
+    G4int n = 0;
+    for (; n<entries && q<end; ++n) q = NextLine(q, end);
+    if (n < entries) break; // Truncated event
+
+    offsets_.push_back(start - data_);
+    p = q;
+  }
+
+  if (SkipSpaces(p, end) != end) {
+    G4Exception("[Decay0FileReader]", "BuildIndex()", JustWarning,
+                "Decay0 file with a malformed or truncated event. "
+                "Only the events before it will be read.");
+  }
+}
+
+
+
+G4bool Decay0FileReader::LoadIndex(const G4String& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) return false;
+
+  Decay0IndexHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  if (!file ||
+      std::memcmp(header.magic, DECAY0_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != DECAY0_INDEX_VERSION ||
+      header.file_size != size_ || header.mtime != mtime_) return false;
+
+  offsets_.resize(header.num_events);
+  file.read(reinterpret_cast<char*>(offsets_.data()),
+            offsets_.size() * sizeof(uint64_t));
+
+  if (!file || (!offsets_.empty() && offsets_.back() >= size_)) {
+    offsets_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+
+
+void Decay0FileReader::SaveIndex(const G4String& filename) const
+{
+  Decay0IndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, DECAY0_INDEX_MAGIC, sizeof(header.magic));
+  header.version    = DECAY0_INDEX_VERSION;
+  header.file_size  = size_;
+  header.mtime      = mtime_;
+  header.num_events = offsets_.size();
+
+  // The index is written under a temporary name and renamed, so that
+  // other jobs never see it incomplete. If the directory is not writable
+  // the index is just built again the next time.
+  G4String tmp_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+
+  std::ofstream file(tmp_filename, std::ios::binary);
+  if (!file.is_open()) return;
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(offsets_.data()),
+             offsets_.size() * sizeof(uint64_t));
+  file.close();
+
+  if (!file || std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    std::remove(tmp_filename.c_str());
+}
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0FileReader.h
+//
+// This class reads the events of an ascii file produced by the Decay0
+// (GENBB) event generator. The file is mapped into memory and an index
+// with the position of every event is built the first time it is opened,
+// and saved next to it to be loaded the following times. Any event can
+// then be read directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DECAY0_FILE_READER_H
+#define DECAY0_FILE_READER_H
+
+#include <globals.hh>
+
+#include <vector>
+#include <cstdint>
+
+
+namespace nexus {
+
+  /// Particle of a Decay0 event
+  struct Decay0Particle {
+    G4int g3code;           ///< GEANT3 particle code
+    G4double px, py, pz;    ///< Momentum components in MeV
+    G4double time;          ///< Time shift from the previous particle in seconds
+  };
+
+  /// Event of a Decay0 file
+  struct Decay0Event {
+    G4long number;
+    G4double time;          ///< Initial time in seconds
+    std::vector<Decay0Particle> particles;
+  };
+
+
+  class Decay0FileReader
+  {
+  public:
+    /// Constructor
+    Decay0FileReader();
+    /// Destructor
+    ~Decay0FileReader();
+
+    /// Opens a Decay0 file, returning false if it cannot be read
+    G4bool Open(const G4String& filename);
+
+    /// Releases the file
+    void Close();
+
+    G4bool IsOpen() const;
+
+    /// Returns the number of (complete) events in the file
+    size_t GetNumberOfEvents() const;
+
+    /// Reads the i-th event of the file (starting at 0),
+    /// returning false if it does not exist
+    G4bool ReadEvent(size_t i, Decay0Event&) const;
+
+  private:
+    /// Finds the position of all the events in the file
+    void BuildIndex();
+    G4bool LoadIndex(const G4String& filename);
+    void SaveIndex(const G4String& filename) const;
+
+  private:
+    const char* data_; ///< Contents of the file (memory mapped)
+    size_t size_;
+    int64_t mtime_;    ///< Modification time of the file (ns)
+
+    std::vector<uint64_t> offsets_; ///< Position of every event
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline G4bool Decay0FileReader::IsOpen() const
+  { return data_ != nullptr; }
+
+  inline size_t Decay0FileReader::GetNumberOfEvents() const
+  { return offsets_.size(); }
+
+} // end namespace nexus
+
+#endif
@@ -29,14 +29,52 @@ REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
-  G4VPrimaryGenerator(), msg_(0), opened_(false), geom_(0)
+  G4VPrimaryGenerator(), msg_(0),
+  first_event_(0), num_slices_(1), slice_(0),
+  min_energy_sum_(0.), max_energy_sum_(4.3*MeV), energy_table_dir_(""),
+  opened_(false), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
     "Control commands of the Decay0 interface.");
 
   msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
-  msg_->DeclareProperty("region", region_, "");
+  msg_->DeclareMethod("region", &Decay0Interface::SetRegion, "");
+
+  G4GenericMessenger::Command& first_event_cmd =
+    msg_->DeclareProperty("first_event", first_event_,
+                          "Index (from 0) of the first event read from the input file.");
+  first_event_cmd.SetParameterName("first_event", false);
+  first_event_cmd.SetRange("first_event >= 0");
+
+  G4GenericMessenger::Command& num_slices_cmd =
+    msg_->DeclareProperty("num_slices", num_slices_,
+                          "Number of interleaved slices the events of the input file are divided into.");
+  num_slices_cmd.SetParameterName("num_slices", false);
+  num_slices_cmd.SetRange("num_slices > 0");
+
+  G4GenericMessenger::Command& slice_cmd =
+    msg_->DeclareProperty("slice", slice_,
+                          "Slice (from 0) of the events of the input file that is read.");
+  slice_cmd.SetParameterName("slice", false);
+  slice_cmd.SetRange("slice >= 0");
+
+  G4GenericMessenger::Command& min_energy_sum_cmd =
+    msg_->DeclareProperty("min_energy_sum", min_energy_sum_,
+                          "Minimum sum of the energies of the two electrons generated by decay0.");
+  min_energy_sum_cmd.SetUnitCategory("Energy");
+  min_energy_sum_cmd.SetParameterName("min_energy_sum", false);
+  min_energy_sum_cmd.SetRange("min_energy_sum >= 0.");
+
+  G4GenericMessenger::Command& max_energy_sum_cmd =
+    msg_->DeclareProperty("max_energy_sum", max_energy_sum_,
+                          "Maximum sum of the energies of the two electrons generated by decay0.");
+  max_energy_sum_cmd.SetUnitCategory("Energy");
+  max_energy_sum_cmd.SetParameterName("max_energy_sum", false);
+  max_energy_sum_cmd.SetRange("max_energy_sum > 0.");
+
+  msg_->DeclareProperty("energy_table_dir", energy_table_dir_,
+                        "Directory where the energy tables of decay0 are saved and reused, as files decay0_<nuclide>_fs<final state>_mode<mode>_<min>-<max>MeV.tab of up to tens of MB (none if empty, the default).");
 
   msg_->DeclareMethod("EnergyThreshold", &Decay0Interface::SetEnergyThreshold, ""); // for electrons only.
   msg_->DeclareMethod("Xe136DecayMode", &Decay0Interface::SetXe136DecayMode, "");
@@ -55,7 +93,6 @@ Decay0Interface::Decay0Interface():
 
 Decay0Interface::~Decay0Interface()
 {
-  if (file_.is_open()) file_.close();
   if (fOutDebug_.is_open()) fOutDebug_.close();
   if (decay0_ != 0) delete decay0_;
 }
@@ -70,11 +107,8 @@ void Decay0Interface::OpenInputFile(G4String filename)
      return;
    }
 
-  file_.open(filename.data());
-
-  if (file_.good()) {
+  if (file_.Open(filename)) {
     opened_ = true;
-    ProcessHeader();
   }
   else {
     G4Exception("[Decay0Interface]", "SetInputFile()", JustWarning,
@@ -93,7 +127,9 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
   if (!opened_) {
      if (decay0_ == 0) {
        const std::string XeName("Xe136");
-       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_);
+       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_,
+                            min_energy_sum_/MeV, max_energy_sum_/MeV,
+                            energy_table_dir_);
       // Temporary debugging file, just generate particle and dump them on a file
 //      std::ostringstream fOutStrStr; fOutStrStr << "./Decay0Out_" << Ba136FinalState_ << "_" << Xe136DecayMode_ << "_V1.txt";
 //      std::string fOutStr(fOutStrStr.str());
@@ -122,7 +158,8 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
         }
      }
      if (runG4 && keepEvt) {
-        particle_position = geom_->GenerateVertex(region_);
+        if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+        particle_position = vertex_region_();
         for (std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++) {
           G4ParticleDefinition* g4code =
              G4ParticleTable::GetParticleTable()->FindParticle(itp->pdgCode_);
@@ -140,44 +177,41 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
   //G4cout << "GeneratePrimaryVertex()" << G4endl;
 
-  // reading event-related information
-  G4int entries;     // number of particles in the event
-  G4long evt_no;     // event number
-  G4double evt_time; // initial time in seconds
-
-  file_ >> evt_no >> evt_time >> entries;
+  if (slice_ >= num_slices_) {
+    G4Exception("[Decay0Interface]", "GeneratePrimaryVertex()", FatalException,
+                "The slice must be smaller than the number of slices.");
+  }
 
+  // Event n of the run is the n-th one of the slice. The event ID is
+  // shared by all the threads, each of which has its own generator, so
+  // that every event of the file is read by only one of them.
+  size_t index = first_event_ + slice_ + size_t(event->GetEventID()) * num_slices_;
 
-  // abort if end-of-file was reached in last operation
-  if (file_.eof()) {
+  // abort if end-of-file was reached
+  if (!file_.ReadEvent(index, event_)) {
     G4cout  << "[Decay0Interface] End-of-File reached. "
             << "Aborting the run..." << G4endl;
     G4RunManager::GetRunManager()->AbortRun();
     return;
   }
 
-  //G4cout << "entries: " << entries << G4endl;
-
   // generate a position in the detector
   // (all primary particles will be generated there)
-  particle_position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  particle_position = vertex_region_();
 
 
   // reading info for each particle in the event
-  for (G4int i=0; i<entries; i++) {
-    //G4cout << i << G4endl;
-
-    G4int g3code;           // GEANT3 particle code
-    G4double px, py, pz;    // Momentum components in MeV
-
-    file_ >> g3code >> px >> py >> pz >> particle_time;
+  for (const Decay0Particle& p: event_.particles) {
 
     G4ParticleDefinition* g4code =
-      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(g3code));
+      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(p.g3code));
+
+    particle_time = p.time;
 
     // create a primary particle
     G4PrimaryParticle* particle =
-      new G4PrimaryParticle(g4code, px*MeV, py*MeV, pz*MeV);
+      new G4PrimaryParticle(g4code, p.px*MeV, p.py*MeV, p.pz*MeV);
 
     particle->SetMass(g4code->GetPDGMass());
     particle->SetCharge(g4code->GetPDGCharge());
@@ -195,18 +229,6 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
 
 
-void Decay0Interface::ProcessHeader()
-{
-  G4String line;
-
-  while (!G4StrUtil::contains(line, "First event")) getline(file_, line);
-
-  getline(file_, line);
-  getline(file_, line);
-}
-
-
-
 G4int Decay0Interface::G3toPDG(const G4int G3code)
 {
   int pdg_code = 0;
@@ -227,3 +249,11 @@ G4int Decay0Interface::G3toPDG(const G4int G3code)
   }
   return pdg_code;
 }
+
+
+void Decay0Interface::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
@@ -13,8 +13,11 @@
 #ifndef DECAY0_INTERFACE_H
 #define DECAY0_INTERFACE_H
 
+#include "Decay0FileReader.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <fstream>
+#include <functional>
 
 class G4GenericMessenger;
 class G4Event;
@@ -42,11 +45,12 @@ namespace nexus {
     /// and primary vertices accordingly
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
     /// Open the Decay0 input file selected by the user
     void OpenInputFile(G4String);
-    /// Parse information in the file header
-    void ProcessHeader();
 
     /// Return the PDG code equivalent to a given GEANT3 particle code
     G4int G3toPDG(const G4int);
@@ -54,8 +58,18 @@ namespace nexus {
   private:
     G4GenericMessenger* msg_;
 
-    std::ifstream file_; ///< ASCII file produced by Decay0
+    Decay0FileReader file_; ///< ASCII file produced by Decay0
+    Decay0Event event_;     ///< Last event read from the file
+
+    G4int first_event_; ///< Index of the first event read from the file
+    G4int num_slices_;  ///< Number of interleaved slices of the events
+    G4int slice_;       ///< Slice of the events read
+
+    G4double min_energy_sum_;    ///< Window of the energy sum generated by decay0
+    G4double max_energy_sum_;
+    G4String energy_table_dir_;  ///< Directory of the energy tables of decay0
     G4String region_; ///< region of generation of vertices in geometry
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
 
     G4bool opened_;
 
@@ -53,7 +53,7 @@ geom_(0)
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &ElecPositronPairGenerator::SetRegion,
     "Set the region of the geometry where the vertex will be generated.");
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
@@ -75,7 +75,8 @@ void ElecPositronPairGenerator::GeneratePrimaryVertex(G4Event* event)
     G4ParticleTable::GetParticleTable()->FindParticle("e-");
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector pos = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector pos = vertex_region_();
 
   // Particle generated at start-of-event
   G4double time = 0.;
@@ -139,3 +140,11 @@ G4double ElecPositronPairGenerator::RandomEnergy(G4double emin, G4double emax) c
   else
     return (G4UniformRand()*(emax - emin) + emin);
 }
+
+
+void ElecPositronPairGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
@@ -12,6 +12,8 @@
 
 #include <G4VPrimaryGenerator.hh>
 
+#include <functional>
+
 class G4GenericMessenger;
 class G4Event;
 class G4ParticleDefinition;
@@ -34,6 +36,9 @@ namespace nexus {
     /// in the event.
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
     /// Generate a random kinetic energy with flat probability in
@@ -52,6 +57,8 @@ namespace nexus {
 
     G4String region_;
 
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
+
   };
 
 } // end namespace nexus
@@ -53,7 +53,7 @@ IonGenerator::IonGenerator():
   msg_->DeclareProperty("decay_at_time_zero", decay_at_time_zero_,
                         "Set to true to make unstable ions decay at t=0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &IonGenerator::SetRegion,
                         "Region of the geometry where vertices will be generated.");
 
   // Load the detector geometry, which will be used for the generation of vertices
@@ -101,7 +101,8 @@ void IonGenerator::GeneratePrimaryVertex(G4Event* event)
   G4PrimaryParticle* ion = new G4PrimaryParticle(pdef);
 
   // Generate an initial position for the ion using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector position = vertex_region_();
   // Ion generated at the start-of-event time
   G4double time = 0.;
   // Create a new vertex
@@ -111,3 +112,11 @@ void IonGenerator::GeneratePrimaryVertex(G4Event* event)
   vertex->SetPrimary(ion);
   event->AddPrimaryVertex(vertex);
 }
+
+
+void IonGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
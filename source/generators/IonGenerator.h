@@ -13,6 +13,8 @@
 
 #include <G4VPrimaryGenerator.hh>
 
+#include <functional>
+
 class G4Event;
 class G4GenericMessenger;
 class G4ParticleDefinition;
@@ -34,6 +36,9 @@ namespace nexus{
     // setting a primary vertex that contains the chosen ion
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
     G4ParticleDefinition* IonDefinition();
 
@@ -42,6 +47,7 @@ namespace nexus{
     G4double energy_level_;
     G4bool decay_at_time_zero_;
     G4String region_;
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
   };
@@ -87,7 +87,7 @@ namespace nexus {
      msg_ = new G4GenericMessenger(this, "/Generator/Kr83mGenerator/",
     "Control commands of Kr83 generator.");
 
-     msg_->DeclareProperty("region", region_,
+     msg_->DeclareMethod("region", &Kr83mGenerator::SetRegion,
 			   "Set the region of the geometry where the vertex will be generated.");
 
      // Set particle type searching in particle table by name
@@ -118,7 +118,8 @@ namespace nexus {
    // const int evtNum = evt->GetEventID();
 
     // Ask the geometry to generate a position for the particle
-    G4ThreeVector position = geom_->GenerateVertex(region_);
+    if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+    G4ThreeVector position = vertex_region_();
    //
    // First transition (32 kEv) Always one electron. Set it's kinetic energy.
    // Decide if we emit an X-ray..
@@ -214,4 +215,12 @@ namespace nexus {
    }
    evt->AddPrimaryVertex(vertex);
   }
+
+
+  void Kr83mGenerator::SetRegion(G4String region)
+  {
+    // The generator of vertices is resolved again in the next event
+    region_ = region;
+    vertex_region_ = nullptr;
+  }
 } // Name space nexus
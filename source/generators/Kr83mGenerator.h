@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <G4VPrimaryGenerator.hh>
+#include <functional>
 
 class G4Event;
 class G4ParticleDefinition;
@@ -57,6 +58,9 @@ namespace nexus {
 
     void GeneratePrimaryVertex(G4Event* evt);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
     G4GenericMessenger* msg_;
@@ -71,6 +75,8 @@ namespace nexus {
                                             // We make cumulative, for easy access for random number.
 
     G4String region_;
+
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
     G4ParticleDefinition*  particle_defgamma_;
     G4ParticleDefinition*  particle_defelectron_;
   };
@@ -50,7 +50,7 @@ MuonAngleGenerator::MuonAngleGenerator():
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &MuonAngleGenerator::SetRegion,
 			"Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclareProperty("angles_on", angular_generation_,
@@ -206,7 +206,8 @@ void MuonAngleGenerator::GeneratePrimaryVertex(G4Event* event)
   G4double mass   = particle_definition_->GetPDGMass();
   G4double energy = kinetic_energy + mass;
 
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector position = vertex_region_();
   
   // Set default momentum and angular variables
   G4ThreeVector p_dir(0., -1., 0.);
@@ -217,7 +218,7 @@ void MuonAngleGenerator::GeneratePrimaryVertex(G4Event* event)
   if (angular_generation_){
     GetDirection(p_dir, zenith, azimuth, energy, kinetic_energy, mass);
     while ( !CheckOverlap(position, p_dir) )
-      position = geom_->GenerateVertex(region_);
+      position = vertex_region_();
   }
 
   G4double pmod   = std::sqrt(energy*energy - mass*mass);
@@ -323,3 +324,11 @@ G4bool MuonAngleGenerator::CheckOverlap(const G4ThreeVector& vtx,
 
   return true;
 }
+
+
+void MuonAngleGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
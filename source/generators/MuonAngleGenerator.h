@@ -14,6 +14,8 @@
 #include <G4RotationMatrix.hh>
 #include <Randomize.hh>
 
+#include <functional>
+
 class G4GenericMessenger;
 class G4Event;
 class G4ParticleDefinition;
@@ -37,6 +39,9 @@ namespace nexus {
     /// in the event.
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
     // Sets the rotation angle and the spectra to
@@ -73,6 +78,8 @@ namespace nexus {
     G4double energy_max_; ///< Maximum kinetic energy
 
     G4String region_; ///< Name of generator region
+
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
     G4String ang_file_; ///< Name of file with distributions
     G4String dist_name_; ///< Name of distribution in file
 
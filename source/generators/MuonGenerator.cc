@@ -47,7 +47,7 @@ MuonGenerator::MuonGenerator():
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &MuonGenerator::SetRegion,
 			"Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclarePropertyWithUnit("momentum", "mm",  momentum_,
@@ -89,7 +89,8 @@ void MuonGenerator::GeneratePrimaryVertex(G4Event* event)
                 FatalException, " can not create a muon ");
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector position = vertex_region_();
   // Particle generated at start-of-event
   G4double time = 0.;
   // Create a new vertex
@@ -168,3 +169,11 @@ G4double MuonGenerator::GetPhi() const
 {
   return twopi*G4UniformRand();
 }
+
+
+void MuonGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
@@ -37,7 +37,7 @@ namespace nexus {
      msg_ = new G4GenericMessenger(this, "/Generator/Na22Generator/",
     "Control commands of Na22 generator.");
 
-     msg_->DeclareProperty("region", region_,
+     msg_->DeclareMethod("region", &Na22Generator::SetRegion,
 			   "Set the region of the geometry where the vertex will be generated.");
 
 
@@ -53,7 +53,8 @@ namespace nexus {
   void Na22Generator::GeneratePrimaryVertex(G4Event* evt)
   {
     // Ask the geometry to generate a position for the particle
-    G4ThreeVector position = geom_->GenerateVertex(region_);
+    if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+    G4ThreeVector position = vertex_region_();
     G4double time = 0.;
     G4PrimaryVertex* vertex =
         new G4PrimaryVertex(position, time);
@@ -116,3 +117,11 @@ namespace nexus {
   }
 
 }
+
+
+void Na22Generator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
@@ -13,6 +13,8 @@
 
 #include <G4VPrimaryGenerator.hh>
 
+#include <functional>
+
 class G4Event;
 class G4GenericMessenger;
 
@@ -30,6 +32,9 @@ namespace nexus {
 
     void GeneratePrimaryVertex(G4Event* evt);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
     G4GenericMessenger* msg_;
@@ -37,6 +42,8 @@ namespace nexus {
 
     G4String region_;
 
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
+
   };
 
 }// end namespace nexus
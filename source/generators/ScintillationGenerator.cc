@@ -21,7 +21,6 @@
 #include <G4ParticleTable.hh>
 #include <G4PrimaryVertex.hh>
 #include <G4Event.hh>
-#include <G4RandomDirection.hh>
 #include <G4OpticalPhoton.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
@@ -38,7 +37,7 @@ ScintillationGenerator::ScintillationGenerator() :
   msg_ = new G4GenericMessenger(this, "/Generator/ScintGenerator/",
     "Control commands of scintillation generator.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &ScintillationGenerator::SetRegion,
                         "Set the region of the geometry where the vertex will be generated.");
 
   msg_->DeclareProperty("nphotons", nphotons_, "Set number of photons");
@@ -60,7 +59,8 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   G4ParticleDefinition* particle_definition = G4OpticalPhoton::Definition();
   // Generate an initial position for the particle using the geometry and set time to 0.
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector position = vertex_region_();
   G4double time = 0.;
 
   // Energy is sampled from integral (like it is done in G4Scintillation)
@@ -68,36 +68,17 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
   G4VPhysicalVolume* vol =
     geom_navigator_->LocateGlobalPointAndSetup(position, 0, false);
   G4Material* mat = vol->GetLogicalVolume()->GetMaterial();
-  G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
 
-  if (!mpt) {
-    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
-                "Material properties not defined for this material!");
-  }
-  // Using fast or slow component here is irrelevant, since we're not using time
-  // and they're are the same in energy.
-  G4MaterialPropertyVector* spectrum = mpt->GetProperty("SCINTILLATIONCOMPONENT1");
-
-  if (!spectrum) {
-    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
-                "Fast time decay constant not defined for this material!");
-  }
-
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    new G4PhysicsOrderedFreeVector();
-  ComputeCumulativeDistribution(*spectrum, *spectrum_integral);
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  // Random isotropic directions, polarizations and energies of all photons
+  photons_.Generate(nphotons_, GetSpectrum(*mat));
 
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
 
   for ( G4int i = 0; i<nphotons_; i++)
     {
-      // Generate random direction by default
-      G4ThreeVector _momentum_direction = G4RandomDirection();
-      // Determine photon energy
-      G4double sc_value = G4UniformRand()*sc_max;
-      G4double pmod = spectrum_integral->GetEnergy(sc_value);
+      G4ThreeVector _momentum_direction = photons_.GetDirection(i);
+      G4double pmod = photons_.GetEnergy(i);
       G4double px = pmod * _momentum_direction.x();
       G4double py = pmod * _momentum_direction.y();
       G4double pz = pmod * _momentum_direction.z();
@@ -106,8 +87,7 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
       G4PrimaryParticle* particle =
         new G4PrimaryParticle(particle_definition, px, py, pz);
 
-      G4ThreeVector polarization = G4RandomDirection();
-      particle->SetPolarization(polarization);
+      particle->SetPolarization(photons_.GetPolarization(i));
 
       // Add particle to the vertex and this to the event
       vertex->SetPrimary(particle);
@@ -115,16 +95,42 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
   event->AddPrimaryVertex(vertex);
 }
 
-void ScintillationGenerator::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
+const SpectrumSampler&
+ScintillationGenerator::GetSpectrum(const G4Material& mat)
 {
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+  size_t idx = mat.GetIndex();
+  if (idx >= spectra_.size()) spectra_.resize(idx+1);
+  if (!spectra_[idx].IsEmpty()) return spectra_[idx];
+
+  G4MaterialPropertiesTable* mpt = mat.GetMaterialPropertiesTable();
+
+  if (!mpt) {
+    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
+                "Material properties not defined for this material!");
   }
+  // Using fast or slow component here is irrelevant, since we're not using time
+  // and they're are the same in energy.
+  G4MaterialPropertyVector* spectrum = mpt->GetProperty("SCINTILLATIONCOMPONENT1");
+
+  if (!spectrum) {
+    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
+                "Fast time decay constant not defined for this material!");
+  }
+
+  spectra_[idx] = SpectrumSampler(*spectrum);
+
+  if (spectra_[idx].IsEmpty()) {
+    G4Exception("[ScintillationGenerator]", "GeneratePrimaryVertex()", FatalException,
+                "Scintillation spectrum of this material is empty!");
+  }
+
+  return spectra_[idx];
+}
+
+
+void ScintillationGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
 }
@@ -11,10 +11,15 @@
 #ifndef SCINTILLATION_GENERATOR_H
 #define SCINTILLATION_GENERATOR_H
 
+#include "SpectrumSampler.h"
+#include "OpticalPhotonBatch.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <G4Navigator.hh>
 #include <G4TransportationManager.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
+
+#include <vector>
+#include <functional>
 
 class G4GenericMessenger;
 class G4Event;
@@ -36,18 +41,28 @@ namespace nexus {
     /// in the event.
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
+    /// Returns the sampler of the scintillation spectrum of
+    /// the material, building it the first time it is used
+    const SpectrumSampler& GetSpectrum(const G4Material&);
 
     G4GenericMessenger* msg_;
     G4Navigator* geom_navigator_; ///< Geometry Navigator
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4String region_;
+
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
     G4int    nphotons_;
 
+    /// Scintillation spectra, indexed by material index
+    std::vector<SpectrumSampler> spectra_;
+    OpticalPhotonBatch photons_; ///< Photons of an event
+
   };
 
 } // end namespace nexus
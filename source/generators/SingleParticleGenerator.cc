@@ -61,7 +61,7 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
   max_energy.SetParameterName("max_energy", false);
   max_energy.SetRange("max_energy>0.");
 
-  msg_->DeclareProperty("region", region_,
+  msg_->DeclareMethod("region", &SingleParticleGenerator::SetRegion,
     "Set the region of the geometry where the vertex will be generated.");
 
 
@@ -136,7 +136,8 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   }
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!vertex_region_) vertex_region_ = geom_->GetVertexRegion(region_);
+  G4ThreeVector position = vertex_region_();
 
   // Particle generated at start-of-event
   G4double time = 0.;
@@ -148,3 +149,11 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   vertex->SetPrimary(particle);
   event->AddPrimaryVertex(vertex);
 }
+
+
+void SingleParticleGenerator::SetRegion(G4String region)
+{
+  // The generator of vertices is resolved again in the next event
+  region_ = region;
+  vertex_region_ = nullptr;
+}
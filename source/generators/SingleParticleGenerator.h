@@ -16,6 +16,8 @@
 
 #include <G4VPrimaryGenerator.hh>
 
+#include <functional>
+
 class G4GenericMessenger;
 class G4Event;
 class G4ParticleDefinition;
@@ -38,6 +40,9 @@ namespace nexus {
     /// in the event.
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Sets the region of the geometry where vertices are generated
+    void SetRegion(G4String);
+
   private:
 
     void SetParticleDefinition(G4String);
@@ -58,6 +63,8 @@ namespace nexus {
 
     G4String region_;
 
+    std::function<G4ThreeVector()> vertex_region_; ///< Resolved from region_
+
     G4ThreeVector momentum_;
 
     G4double costheta_min_;
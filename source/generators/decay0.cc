@@ -10,7 +10,11 @@
 
 #include <cfloat>
 #include <complex>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
 #include "decay0.h"
+#include "Decay0EnergyTable.h"
 #include <G4RandomDirection.hh>
 #include <Randomize.hh>
 
@@ -41,7 +45,8 @@ emass_(0.51099906),
 nuclideName_("Xe136"),
 fsNum_(0),
 modebb_(0),
-modebbOld_(0)
+modebbOld_(0),
+tableDir_("")
 {
   ebb1_ = 0.;
   ebb2_ = 4.3; // original code, line 628
@@ -49,13 +54,15 @@ modebbOld_(0)
   fillInfo();
 }
 decay0::decay0(const std::string nuclide, int finalStateNumber,
-               int decayModeNumber, double eRangeLow, double eRangeHigh):
+               int decayModeNumber, double eRangeLow, double eRangeHigh,
+               const std::string tableDir):
 ready_(false),
 emass_(0.51099906),
 nuclideName_(nuclide),
 fsNum_(finalStateNumber),
 modebb_(decayModeNumber),
-modebbOld_(decayModeNumber)
+modebbOld_(decayModeNumber),
+tableDir_(tableDir)
 {
   ebb1_ = eRangeLow;
   ebb2_ = eRangeHigh; // for mode 4, 2nbbdecay.
@@ -217,7 +224,6 @@ void decay0::initSpectrum() {
   double rerrAchieved = 0.;
   int iiMax = static_cast<int>(e0_*1000.); //kEv, as int if I followed correctly...
   spthe1_.resize(iiMax);
-  spthe2_.resize(iiMax);
   std::vector<double> params(10, 0.); // For integration.. oversized
   params[0] = emass_; //
   params[1] = bbNucl_.Zdbb_;
@@ -381,8 +387,85 @@ void decay0::initSpectrum() {
 	   }
 	   toallevents_ = r1/r2;
      }
+     this->initEnergyTable();
      std::cout << " .... starting the generation " << std::endl;
 }
+// Shortest decimal representation of x that reads back as x, so that the
+// name of the file of a table identifies its window of the energy sum.
+static std::string shortestDouble(double x) {
+  std::string str;
+  for (int precision=1; precision<=17; precision++) {
+    std::ostringstream os;
+    os << std::setprecision(precision) << x;
+    str = os.str();
+    if (std::strtod(str.c_str(), 0) == x) break;
+  }
+  return str;
+}
+//
+// The energies of the two particles are sampled from tables, in constant
+// time per event, instead of by rejection against spmax_ (first energy)
+// and against the maximum of its spectrum (second energy, recomputed for
+// every event). The table of the first energy follows spthe1_. For modes
+// in which the second energy is random as well, both are tabulated in
+// cells of 1 keV from the two-dimensional distribution, which takes some
+// time: the table is saved in tableDir_ (unless empty) and shared by all
+// the threads. The file also stores the full parameters of the table,
+// which are checked when it is loaded.
+//
+void decay0::initEnergyTable() {
+  const double binWidth = 0.001; // 1 keV, as spthe1_
+  double (*fe12_modXX)(double, void*) = 0;
+  switch(modebb_) {
+    case 4:  fe12_modXX = &decay0::fe12_mod4;  break;
+    case 5:  fe12_modXX = &decay0::fe12_mod5;  break;
+    case 6:  fe12_modXX = &decay0::fe12_mod6;  break;
+    case 8:  fe12_modXX = &decay0::fe12_mod8;  break;
+    case 13: fe12_modXX = &decay0::fe12_mod13; break;
+    case 14: fe12_modXX = &decay0::fe12_mod14; break;
+    case 15: fe12_modXX = &decay0::fe12_mod15; break;
+    case 16: fe12_modXX = &decay0::fe12_mod16; break;
+  }
+  if (fe12_modXX == 0) {
+    // Only the first energy is random. Bin k of spthe1_ covers [k+1, k+2) keV.
+    std::shared_ptr<nexus::Decay0EnergyTable> table(new nexus::Decay0EnergyTable());
+    const double eLow = (modebb_ == 10) ? ebb1_ : 0.;
+    table->Build(spthe1_, binWidth, binWidth, eLow, ebb2_);
+    energyTable_ = table;
+  } else {
+    // The density is zero above e0_, so the table ends there
+    const double sumLow = ebb1_;
+    const double sumHigh = std::min(ebb2_, e0_);
+    std::ostringstream key;
+    key << std::setprecision(17) << nuclideName_ << " final state " << fsNum_
+        << " mode " << modebb_ << " e0 " << e0_ << " energy sum "
+        << sumLow << " " << sumHigh << " bin " << binWidth;
+    std::string filename;
+    if (!tableDir_.empty()) {
+      std::ostringstream fname;
+      fname << tableDir_ << "/decay0_" << nuclideName_ << "_fs" << fsNum_
+            << "_mode" << modebbOld_ << "_" << shortestDouble(sumLow)
+            << "-" << shortestDouble(sumHigh) << "MeV.tab";
+      filename = fname.str();
+    }
+    std::vector<double> params(10, 0.);
+    params[0] = emass_;
+    params[1] = bbNucl_.Zdbb_;
+    params[2] = e0_;
+    energyTable_ = nexus::Decay0EnergyTable::Get(key.str(), filename,
+      [&](nexus::Decay0EnergyTable& table) {
+        std::cout << " decay0::initEnergyTable, tabulating the energies of the two particles " << std::endl;
+        table.Build([&](double e1, double e2) {
+                      params[3] = e1;
+                      return fe12_modXX(e2, &params[0]); },
+                    binWidth, sumLow, sumHigh);
+      });
+  }
+  if (energyTable_->IsEmpty()) {
+    std::cerr << " decay0::initEnergyTable, no energies allowed in the range "
+              << ebb1_ << " - " << ebb2_ << " for decay mode " << modebb_ << std::endl;
+  }
+}
 //
 // Subroutine GENBBsub generates the events of decay of natural
 // radioactive nuclides and various modes of double beta decay.
@@ -415,11 +498,6 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 //                                                          Salvador Dali
 // ***********************************************************************
   const double twopi = 2.0*M_PI;
-  std::vector<double> params(10, 0.);
-  params[0] = emass_; //
-  params[1] = bbNucl_.Zdbb_;
-  params[2] = e0_;
-  void *p = &params[0];
 
   if (modebb_ == 9) {
 //  fixed energies of e+ and X-ray; no angular correlation
@@ -446,94 +524,26 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
     return;
   }
 
-// sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
+// sampling the energies from the tables filled in initEnergyTable.
+  if (!energyTable_ || energyTable_->IsEmpty()) {
+    outPart.clear();
+    return;
+  }
   double e2=0.;
-  int numThrow = 0;
-//  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
-     if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
-     else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
-//     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
-     const size_t k = static_cast<size_t>(static_cast<int>(e1_*1000.) - 1);
-     if (k >= spthe1_.size()) continue;
-     if(spmax_*G4UniformRand() < spthe1_[k]) break;
-     numThrow++;
-     if (numThrow%1000 == 0) std::cerr << " Thrwing e1 ... " << numThrow
-                                       << " times ... " << std::endl;
+  if (energyTable_->HasSecondEnergy()) {
+    if (!energyTable_->Shoot(e1_, e2)) {
+      outPart.clear();
+      return;
+    }
   }
+  else e1_ = energyTable_->Shoot();
 //  second e-/e+ or X-ray
    if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
           (modebb_ == 7) || (modebb_ == 17) || (modebb_==18)) {
 // modes with no emission of other particles beside of two e-/e+:
 //  energy of second e-/e+ is calculated
       e2 =e0_ - e1_;
-   } else if ((modebb_ == 4) || (modebb_ == 5) || (modebb_ == 6) ||
-            (modebb_ == 8) || (modebb_ == 13) || (modebb_ == 14) ||
-            (modebb_ == 15) || (modebb_ == 16))  {
-// something else is emitted - energy of second e-/e+ is random
-	double re2s = std::max(0., (ebb1_ - e1_));
-	double re2f = ebb2_ - e1_;
-	double f2max = -1;
-	params[3] = e1_;
-	int ke2s = std::max(0, static_cast<int>(re2s*1000.)-1);
-	int ke2f= static_cast<int>(re2f*1000.) -1;
-	for (int ke2 = ke2s; ke2 != ke2f; ke2++) {
-	   e2 = 0.0005 + static_cast<double>(ke2)/1000.; // add 1/2 a bin...
-	   size_t kke2 = static_cast<size_t>(ke2) -1;
-	   if (kke2 >= spthe2_.size()) continue; // Should not occur often..
-	   switch(modebb_) {
-	   case 4 :
-	      spthe2_[kke2] = fe2_mod4(e2, p); break;
-	   case 5 :
-	      spthe2_[kke2] = fe2_mod5(e2, p); break;
-	   case 6 :
-	      spthe2_[kke2] = fe2_mod6(e2, p); break;
-	   case  8 :
-	       spthe2_[kke2] = fe2_mod8(e2, p); break;
-	   case 13 :
-	       spthe2_[kke2] = fe2_mod13(e2, p); break;
-	   case 14 :
-	     spthe2_[kke2] = fe2_mod14(e2, p); break;
-	   case 15 :
-	     spthe2_[kke2] = fe2_mod15(e2, p); break;
-	   case 16 :
-	     spthe2_[kke2] = fe2_mod16(e2, p); break;
-	   default:
-	     spthe2_[kke2] = 0.;
-	   }
-	   f2max = std::max(f2max, spthe2_[kke2]);
-	}
-//	std::cerr << " real f2max= "  << f2max << std::endl;
-
-// c2	   e2=(e0-e1)*rnd1(d)
-// sampling the energies: second e-/e+ Acceptance/rejection method (Von Neumann), again
-//
-        while(true) {
-	 e2 = re2s + (re2f-re2s)*G4UniformRand();
-	 double fe2=0.;
-	 switch(modebb_) {
-	   case 4 :
-	     fe2 = fe2_mod4(e2, p); break;
-	   case 5 :
-	     fe2 = fe2_mod5(e2, p); break;
-	   case 6 :
-	     fe2 = fe2_mod6(e2, p); break;
-	   case 8 :
-	     fe2 = fe2_mod8(e2, p); break;
-	   case 13 :
-	     fe2 = fe2_mod13(e2, p); break;
-	   case 14 :
-	     fe2 = fe2_mod14(e2, p); break;
-	   case 15 :
-	     fe2 = fe2_mod15(e2, p); break;
-	   case 16 :
-	     fe2 = fe2_mod16(e2, p); break;
-	   default :
-	     fe2 = 0.; break;
-	 }
-	 if ( f2max*G4UniformRand() < fe2) break;
-        }
-      } else if( modebb_ == 10) {
+   } else if( modebb_ == 10) {
 // energy of X-ray is fixed; no angular correlation
            this->timedParticle(outPart, 2, e1_, e1_, 0., M_PI, 0., twopi, 0., 0.);
            this->timedParticle(outPart, 1, bbNucl_.EK_, bbNucl_.EK_, 0., M_PI, 0., twopi, 0., 0.);
@@ -600,30 +610,39 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 	   endif
 	endif
 	*/
-      const double romaxt = a + std::abs(b) + c;
-      double phi1=0.; double phi2=0.; double ctet1 = 1.0; double stet1 = 0.0;
-      double ctet2 = 1.0; double stet2 = 0.0;
-      numThrow = 0;
-      while(true) {
-	  phi1 = twopi * G4UniformRand();
-	  ctet1 = 1. - 2.* G4UniformRand();
-	  stet1 = std::sqrt(1. - ctet1*ctet1);
-	  phi2= twopi * G4UniformRand();
-	  ctet2 = 1. - 2.*G4UniformRand();
-	  stet2=std::sqrt(1. - ctet2*ctet2);
-	  const double ctet = ctet1*ctet2 + stet1*stet2*std::cos(phi1-phi2);
-	  if((romaxt*G4UniformRand()) < (a + b*ctet + c*ctet*ctet)) break;
-	  numThrow++;
-	  if (numThrow%10000 == 0) {
-	     std::cerr << " Angular distribution Von Neumann accp/rej numThrow " << numThrow << std::endl;
-	     std::cerr << " e1_ " << e1_ << " e2 " << e2 << " a " << a
-                       << " b  " << b << " c " << c  << std::endl;
-	  }
-	  if (numThrow > 1000000) {
-	    outPart.clear();
-	    return;
+// The first particle is emitted isotropically, and the cosine of the angle
+// between both is distributed as a + b*ctet + c*ctet*ctet, by inversion of
+// its cumulative distribution when c = 0 (Von Neumann otherwise). This is
+// the same as accepting two isotropic directions with that probability.
+      const double phi1 = twopi * G4UniformRand();
+      const double ctet1 = 1. - 2.* G4UniformRand();
+      const double stet1 = std::sqrt(1. - ctet1*ctet1);
+      double ctet = 1.;
+      if ((c == 0.) && (a > 0.)) {
+	  const double u = G4UniformRand();
+	  const double d = std::max(0., (a-b)*(a-b) + 4.*a*b*u);
+	  ctet = (b - 2.*a + 4.*a*u)/(std::sqrt(d) + a);
+      } else {
+	  const double romaxt = a + std::abs(b) + c;
+	  int numThrow = 0;
+	  while(true) {
+	    ctet = 1. - 2.*G4UniformRand();
+	    if((romaxt*G4UniformRand()) < (a + b*ctet + c*ctet*ctet)) break;
+	    numThrow++;
+	    if (numThrow > 1000000) {
+	      std::cerr << " Angular distribution Von Neumann accp/rej numThrow " << numThrow << std::endl;
+	      std::cerr << " e1_ " << e1_ << " e2 " << e2 << " a " << a
+	                << " b  " << b << " c " << c  << std::endl;
+	      outPart.clear();
+	      return;
+	    }
 	  }
       }
+      ctet = std::min(1., std::max(-1., ctet));
+      const double stet = std::sqrt(1. - ctet*ctet);
+      const double phi = twopi * G4UniformRand();
+      G4ThreeVector dir2(stet*std::cos(phi), stet*std::sin(phi), ctet);
+      dir2.rotateUz(G4ThreeVector(stet1*std::cos(phi1), stet1*std::sin(phi1), ctet1));
       decay0Part aP;
       if(bbNucl_.Zdbb_ > 0.) aP.pdgCode_ = 11;
       else aP.pdgCode_ = -11;
@@ -633,9 +652,9 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
       aP.time_ = 0.;
       aP.energy_ = e1_;
       outPart.push_back(aP); // same particle id as above..
-      aP.pmom_[0] = p2*stet2*std::cos(phi2);
-      aP.pmom_[1] = p2*stet2*std::sin(phi2);
-      aP.pmom_[2] = p2*ctet2;
+      aP.pmom_[0] = p2*dir2.x();
+      aP.pmom_[1] = p2*dir2.y();
+      aP.pmom_[2] = p2*dir2.z();
       aP.energy_ = e2;
       outPart.push_back(aP); // same particle id as above..
     //
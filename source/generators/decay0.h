@@ -14,8 +14,11 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <memory>
 #include <gsl/gsl_integration.h>
 
+namespace nexus { class Decay0EnergyTable; }
+
 struct decay0Part {
   int pdgCode_;
   double pmom_[3];
@@ -54,7 +57,8 @@ class decay0 {
 
      decay0();
      decay0(const std::string nuclide, int finalStateNumber, int decayModeNumber,
-                 double eRangeLow=0.0, double eRangeHigh=4.3); // no limits, be default. (for 2nbbdecay. )
+                 double eRangeLow=0.0, double eRangeHigh=4.3, // no limits, be default. (for 2nbbdecay. )
+                 const std::string tableDir=""); // where the energy tables are saved, none if empty
      ~decay0();
     void decay0DoIt(std::vector<decay0Part> &outPart) const ;
     void fillInfo(); // to be used if the Nuclide, final state or decay mode is changed...Not advised..
@@ -90,9 +94,12 @@ class decay0 {
     mutable double e1_;
     mutable double ebb1_;
     mutable double ebb2_;
-    mutable std::vector<double> spthe2_;
+    std::string tableDir_;
+    // Energies of the two particles, tabulated for the mode and energy range.
+    std::shared_ptr<const nexus::Decay0EnergyTable> energyTable_;
 
     void initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
+    void initEnergyTable(); // Called from initSpectrum, tabulate (or load) the energies of the two particles.
     void decay0DoItbb(std::vector<decay0Part> &outPart) const; // Main method, generate the two electrons.
     void Ba136low(std::vector<decay0Part> &outPart) const;  // Baryum 136 de-excitation.
 //    void Xe130low(std::vector<decay0Part> &outPart) const;  // Xenon de-excitation. // we (NEXT) don't care...
@@ -149,8 +156,6 @@ class decay0 {
         ebb1_ = e1; ebb2_=e2;
 	size_t nnE1= static_cast<size_t> (e1*1000.) + 1;
 	spthe1_.resize(nnE1);
-	size_t nnE2= static_cast<size_t> (e2*1000.) + 1;
-	spthe2_.resize(nnE2);
     } // Advanced option ?
     inline std::string GetNuclide() const { return nuclideName_;}
     inline size_t GetFinalStateNumber() { return fsNum_;}
@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+// nexus | GeometryBase.cc
+//
+// This is an abstract base class for encapsulation of geometries.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "GeometryBase.h"
+
+#include "VolumePointSampler.h"
+
+using namespace nexus;
+
+
+
+GeometryBase::GeometryBase():
+  logicVol_(0), span_(25.*m), drift_(false), el_z_(0.*mm)
+{
+}
+
+
+
+GeometryBase::~GeometryBase()
+{
+}
+
+
+
+GeometryBase::VertexRegion
+GeometryBase::GetVertexRegion(const G4String& region) const
+{
+  G4bool by_volume = region.rfind("VOLUME:", 0) == 0;
+  G4bool by_mass   = region.rfind("MASS:", 0) == 0;
+
+  if (!by_volume && !by_mass) return ResolveVertexRegion(region);
+
+  std::lock_guard<std::mutex> lock(volume_samplers_mutex_);
+
+  std::shared_ptr<VolumePointSampler>& sampler = volume_samplers_[region];
+  if (!sampler) {
+    G4String name = region.substr(region.find(':') + 1);
+    sampler = std::make_shared<VolumePointSampler>(name, by_mass);
+  }
+
+  return [sampler]() { return sampler->Shoot(); };
+}
+
+
+
+GeometryBase::VertexRegion
+GeometryBase::ResolveVertexRegion(const G4String& region) const
+{
+  return [this, region]() { return GenerateVertex(region); };
+}
@@ -10,14 +10,22 @@
 #define GEOMETRY_BASE_H
 
 #include <G4ThreeVector.hh>
+#include <G4String.hh>
 #include <CLHEP/Units/SystemOfUnits.h>
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
 class G4LogicalVolume;
 
 namespace nexus {
 
   using namespace CLHEP;
 
+  class VolumePointSampler;
+
   /// Abstract base class for encapsulation of detector geometries.
 
   class GeometryBase
@@ -34,6 +42,16 @@ namespace nexus {
     /// Returns a point within a given region of the geometry
     virtual G4ThreeVector GenerateVertex(const G4String&) const;
 
+    /// Generator of points in a region of the geometry
+    typedef std::function<G4ThreeVector()> VertexRegion;
+
+    /// Returns the generator of points in a given region of the geometry,
+    /// to be resolved once (after the geometry is constructed) and called
+    /// for every vertex. Regions VOLUME:<name> and MASS:<name> are
+    /// available in any geometry and give points in all the copies of
+    /// the physical or logical volume <name>, weighted by volume or mass.
+    VertexRegion GetVertexRegion(const G4String&) const;
+
     /// Returns the span (maximum dimension) of the geometry
     G4double GetSpan();
 
@@ -72,6 +90,12 @@ namespace nexus {
     /// Sets the 3 dimensions of the geometry (x, y, z)
     void SetDimensions(G4ThreeVector dim);
 
+    /// Resolves the regions of the geometry for GetVertexRegion.
+    /// By default, the generator calls GenerateVertex with the name of
+    /// the region. Geometries overriding this method should implement
+    /// GenerateVertex by calling the generator it returns.
+    virtual VertexRegion ResolveVertexRegion(const G4String&) const;
+
   private:
     /// Copy-constructor (hidden)
     GeometryBase(const GeometryBase&);
@@ -84,15 +108,16 @@ namespace nexus {
     G4ThreeVector dimensions_; ///< XYZ dimensions of a regular geometry
     G4bool drift_; ///< True if geometry contains a drift field (for hit coordinates)
     G4double el_z_; ///< Starting point of EL generation in z
+
+    /// Samplers of the VOLUME: and MASS: regions, shared by all the
+    /// generators of points in the same region
+    mutable std::map<G4String, std::shared_ptr<VolumePointSampler>> volume_samplers_;
+    mutable std::mutex volume_samplers_mutex_;
   };
 
 
   // Inline definitions ///////////////////////////////////
 
-  inline GeometryBase::GeometryBase(): logicVol_(0), span_(25.*m), drift_(false), el_z_(0.*mm) {}
-
-  inline GeometryBase::~GeometryBase() {}
-
   inline G4LogicalVolume* GeometryBase::GetLogicalVolume() const
   { return logicVol_; }
 
@@ -175,11 +175,18 @@ namespace nexus {
 
   G4ThreeVector Next100::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
+    return ResolveVertexRegion(region)();
+  }
+
+
+  GeometryBase::VertexRegion
+  Next100::ResolveVertexRegion(const G4String& region) const
+  {
+    VertexRegion vertex_region;
 
     // Air around shielding
     if (region == "LAB") {
-      vertex = lab_gen_->GenerateVertex("INSIDE");
+      vertex_region = [this]() { return lab_gen_->GenerateVertex("INSIDE"); };
     }
 
     // Shielding regions
@@ -191,7 +198,7 @@ namespace nexus {
              (region == "PEDESTAL") ||
              (region == "BUBBLE_SEAL") ||
              (region == "EDPM_SEAL")) {
-      vertex = shielding_->GenerateVertex(region);
+      vertex_region = shielding_->GetVertexRegion(region);
     }
 
     // Vessel regions
@@ -200,12 +207,12 @@ namespace nexus {
              (region == "PORT_2a") ||
              (region == "PORT_1b") ||
              (region == "PORT_2b")) {
-      vertex = vessel_->GenerateVertex(region);
+      vertex_region = vessel_->GetVertexRegion(region);
     }
 
     // Inner copper shielding
     else if (region == "ICS"){
-      vertex = ics_->GenerateVertex(region);
+      vertex_region = ics_->GetVertexRegion(region);
     }
 
     // Inner elements (photosensors' planes and field cage)
@@ -231,32 +238,30 @@ namespace nexus {
              (region == "GATE_RING") ||
              (region == "ANODE_RING") ||
              (region == "RING_HOLDER")) {
-      vertex = inner_elements_->GenerateVertex(region);
+      vertex_region = inner_elements_->GetVertexRegion(region);
     }
 
     else if (region == "AD_HOC") {
       // AD_HOC does not need to be shifted because it is passed by the user
-      vertex = specific_vertex_;
-      return vertex;
+      return [this]() { return specific_vertex_; };
     }
 
     // Lab walls
     else if ((region == "HALLA_INNER") || (region == "HALLA_OUTER")){
       if (!lab_walls_)
-	G4Exception("[Next100]", "GenerateVertex()", FatalException,
+	G4Exception("[Next100]", "ResolveVertexRegion()", FatalException,
                     "This vertex generation region must be used with lab_walls == true!");
-      vertex = hallA_walls_->GenerateVertex(region);
+      vertex_region = hallA_walls_->GetVertexRegion(region);
     }
 
     else {
-      G4Exception("[Next100]", "GenerateVertex()", FatalException,
+      G4Exception("[Next100]", "ResolveVertexRegion()", FatalException,
 		  "Unknown vertex generation region!");
     }
 
     G4ThreeVector displacement = G4ThreeVector(0., 0., -gate_zpos_in_vessel_);
-    vertex = vertex + displacement;
 
-    return vertex;
+    return [vertex_region, displacement]() { return vertex_region() + displacement; };
   }
 
 } //end namespace nexus
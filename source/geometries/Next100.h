@@ -42,6 +42,7 @@ namespace nexus {
   private:
     void BuildLab();
     void Construct();
+    VertexRegion ResolveVertexRegion(const G4String& region) const;
 
 
   private:
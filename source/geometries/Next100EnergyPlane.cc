@@ -11,6 +11,7 @@
 #include "OpticalMaterialProperties.h"
 #include "Visibilities.h"
 #include "CylinderPointSampler2020.h"
+#include "CellPointSampler.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4PVPlacement.hh>
@@ -80,10 +81,6 @@ namespace nexus {
     ///    in the gas volume, inside the holes excavated in the copper.
 
 
-    /// Initializing the geometry navigator (used in vertex generation)
-    geom_navigator_ =
-      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
-
     /// Messenger
     msg_ = new G4GenericMessenger(this, "/Geometry/Next100/",
 				  "Control commands of geometry Next100.");
@@ -391,6 +388,26 @@ namespace nexus {
     optical_pad_gen_     = new CylinderPointSampler2020(optical_pad_phys);
     pmt_base_gen_        = new CylinderPointSampler2020(pmt_base_phys);
 
+    // The copper plate is full of holes, and the sapphire windows have
+    // daughters, so their samplers are restricted to the volumes.
+    // The cells are classified the first time a vertex is generated.
+    G4ThreeVector to_global(0., 0., -GetELzCoord());
+
+    CylinderPointSampler2020* copper_gen = copper_gen_;
+    copper_cells_ = new CellPointSampler(
+      [copper_gen](G4double u_phi, G4double u_rad, G4double u_z) {
+        return copper_gen->GetVolumePoint(u_phi, u_rad, u_z);
+      },
+      {"EP_COPPER_PLATE"}, to_global);
+
+    CylinderPointSampler2020* sapphire_gen = sapphire_window_gen_;
+    G4ThreeVector first_window_pos =
+      pmt_positions_[0] + G4ThreeVector(0., 0., vacuum_posz_);
+    sapphire_window_cells_ = new CellPointSampler(
+      [sapphire_gen, first_window_pos](G4double u_phi, G4double u_rad, G4double u_z) {
+        return sapphire_gen->GetVolumePoint(u_phi, u_rad, u_z) + first_window_pos;
+      },
+      {"SAPPHIRE_WINDOW"}, to_global);
   }
 
 
@@ -400,78 +417,80 @@ namespace nexus {
     delete sapphire_window_gen_;
     delete optical_pad_gen_;
     delete pmt_base_gen_;
+    delete copper_cells_;
+    delete sapphire_window_cells_;
   }
 
 
   G4ThreeVector Next100EnergyPlane::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0., 0., 0.);
+    return ResolveVertexRegion(region)();
+  }
 
+
+  GeometryBase::VertexRegion
+  Next100EnergyPlane::ResolveVertexRegion(const G4String& region) const
+  {
     // Copper plate
     // As it is full of holes, let's get sure vertices are in the right volume
     if (region == "EP_COPPER_PLATE") {
-      G4VPhysicalVolume *VertexVolume;
-      do {
-        vertex = copper_gen_->GenerateVertex("VOLUME");
-        G4ThreeVector glob_vtx(vertex);
-        glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-        VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-      } while (VertexVolume->GetName() != region);
+      return [this]() { return copper_cells_->Shoot(); };
     }
 
     // Sapphire windows
+    // Points are generated in the first one and moved to a random one
     else if (region == "SAPPHIRE_WINDOW") {
-      G4VPhysicalVolume *VertexVolume;
-      do {
-        vertex = sapphire_window_gen_->GenerateVertex("VOLUME");
+      return [this]() {
+        G4ThreeVector vertex = sapphire_window_cells_->Shoot();
         G4double rand = num_PMTs_ * G4UniformRand();
-        G4ThreeVector sapphire_pos = pmt_positions_[int(rand)];
-        vertex += sapphire_pos;
-        G4double z_translation = vacuum_posz_;
-        vertex.setZ(vertex.z() + z_translation);
-        G4ThreeVector glob_vtx(vertex);
-        glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-        VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-      } while (VertexVolume->GetName() != region);
+        return vertex + pmt_positions_[int(rand)] - pmt_positions_[0];
+      };
     }
 
     // Optical pads
     else if (region == "OPTICAL_PAD") {
-      vertex = optical_pad_gen_->GenerateVertex("VOLUME");
-      G4double rand = num_PMTs_ * G4UniformRand();
-      G4ThreeVector optical_pad_pos = pmt_positions_[int(rand)];
-      vertex += optical_pad_pos;
-      G4double z_translation = vacuum_posz_;
-      vertex.setZ(vertex.z() + z_translation);
+      return [this]() {
+        G4ThreeVector vertex = optical_pad_gen_->GenerateVertex("VOLUME");
+        G4double rand = num_PMTs_ * G4UniformRand();
+        G4ThreeVector optical_pad_pos = pmt_positions_[int(rand)];
+        vertex += optical_pad_pos;
+        G4double z_translation = vacuum_posz_;
+        vertex.setZ(vertex.z() + z_translation);
+        return vertex;
+      };
     }
 
     // PMTs (What to do with them ?? Should we update to the new vertex generators??)
     else  if (region == "PMT" || region == "PMT_BODY") {
-      G4ThreeVector ini_vertex = pmt_->GenerateVertex(region);
-      ini_vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
-      G4double rand = num_PMTs_ * G4UniformRand();
-      G4ThreeVector pmt_pos = pmt_positions_[int(rand)];
-      vertex = ini_vertex + pmt_pos;
-      G4double z_translation = vacuum_posz_ + pmt_zpos_;
-      vertex.setZ(vertex.z() + z_translation);
+      VertexRegion pmt_region = pmt_->GetVertexRegion(region);
+      return [this, pmt_region]() {
+        G4ThreeVector ini_vertex = pmt_region();
+        ini_vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
+        G4double rand = num_PMTs_ * G4UniformRand();
+        G4ThreeVector pmt_pos = pmt_positions_[int(rand)];
+        G4ThreeVector vertex = ini_vertex + pmt_pos;
+        G4double z_translation = vacuum_posz_ + pmt_zpos_;
+        vertex.setZ(vertex.z() + z_translation);
+        return vertex;
+      };
     }
 
     // PMT bases
     else if (region == "PMT_BASE") {
-      vertex = pmt_base_gen_->GenerateVertex("VOLUME");
-      G4double rand = num_PMTs_ * G4UniformRand();
-      G4ThreeVector pmt_base_pos = pmt_positions_[int(rand)];
-      vertex += pmt_base_pos;
-      G4double z_translation = vacuum_posz_;
-      vertex.setZ(vertex.z() + z_translation);
-    }
-
-    else {
-      G4Exception("[Next100EnergyPlane]", "GenerateVertex()", FatalException,
-     		  "Unknown vertex generation region!");
+      return [this]() {
+        G4ThreeVector vertex = pmt_base_gen_->GenerateVertex("VOLUME");
+        G4double rand = num_PMTs_ * G4UniformRand();
+        G4ThreeVector pmt_base_pos = pmt_positions_[int(rand)];
+        vertex += pmt_base_pos;
+        G4double z_translation = vacuum_posz_;
+        vertex.setZ(vertex.z() + z_translation);
+        return vertex;
+      };
     }
 
-    return vertex;
+    G4Exception("[Next100EnergyPlane]", "ResolveVertexRegion()", FatalException,
+                "Unknown vertex generation region!");
+    return VertexRegion();
   }
 
 
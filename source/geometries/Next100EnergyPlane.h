@@ -25,6 +25,7 @@ namespace nexus {
   /// This is a class to place all the components of the energy plane
 
   class CylinderPointSampler2020;
+  class CellPointSampler;
 
   class Next100EnergyPlane: public GeometryBase
   {
@@ -50,6 +51,8 @@ namespace nexus {
 
 
   private:
+    VertexRegion ResolveVertexRegion(const G4String& region) const;
+
     void GeneratePositions();
     void PrintPMTPositions() const;
 
@@ -76,9 +79,6 @@ namespace nexus {
     // Visibility of the energy plane
     G4bool visibility_, verbosity_;
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
-
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
 
@@ -100,6 +100,11 @@ namespace nexus {
     CylinderPointSampler2020* optical_pad_gen_;
     CylinderPointSampler2020* pmt_base_gen_;
 
+    // Samplers restricted to the volumes of the copper plate and of
+    // the first sapphire window (all windows being identical)
+    CellPointSampler* copper_cells_;
+    CellPointSampler* sapphire_window_cells_;
+
   };
 
   inline void Next100EnergyPlane::SetELtoSapphireWDWdistance(G4double z) {
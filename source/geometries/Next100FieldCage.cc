@@ -12,8 +12,10 @@
 #include "IonizationSD.h"
 #include "OpticalMaterialProperties.h"
 #include "UniformElectricDriftField.h"
+#include "RadiusDependentDriftField.h"
 #include "XenonProperties.h"
 #include "CylinderPointSampler2020.h"
+#include "CellPointSampler.h"
 
 #include <G4Navigator.hh>
 #include <G4SystemOfUnits.hh>
@@ -83,6 +85,7 @@ Next100FieldCage::Next100FieldCage():
   // Diffusion constants
   drift_transv_diff_ (1. * mm/sqrt(cm)),
   drift_long_diff_ (.3 * mm/sqrt(cm)),
+  drift_field_map_ (""),
   ELtransv_diff_ (0. * mm/sqrt(cm)),
   ELlong_diff_ (0. * mm/sqrt(cm)),
   // EL electric field
@@ -102,10 +105,6 @@ Next100FieldCage::Next100FieldCage():
   new G4UnitDefinition("kilovolt/cm","kV/cm","Electric field", kilovolt/cm);
   new G4UnitDefinition("mm/sqrt(cm)","mm/sqrt(cm)","Diffusion", mm/sqrt(cm));
 
-  /// Initializing the geometry navigator (used in vertex generation)
-  geom_navigator_ =
-    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
-
   /// Messenger
   msg_ = new G4GenericMessenger(this, "/Geometry/Next100/",
                                 "Control commands of geometry Next100.");
@@ -124,6 +123,10 @@ Next100FieldCage::Next100FieldCage():
   drift_long_diff_cmd.SetParameterName("drift_long_diff", true);
   drift_long_diff_cmd.SetUnitCategory("Diffusion");
 
+  msg_->DeclareProperty("drift_field_map", drift_field_map_,
+                        "File with the (r,z) map of the drift field. "
+                        "If empty, the drift field is uniform.");
+
   G4GenericMessenger::Command&  ELtransv_diff_cmd =
   msg_->DeclareProperty("ELtransv_diff", ELtransv_diff_,
                         "Tranvsersal diffusion in the EL region");
@@ -235,6 +238,7 @@ void Next100FieldCage::Construct()
   BuildELRegion();
   BuildLightTube();
   BuildFieldCage();
+  BuildVertexSamplers();
 }
 
 
@@ -324,15 +328,24 @@ void Next100FieldCage::BuildActive()
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
   /// Define a drift field for this volume
-  UniformElectricDriftField* field = new UniformElectricDriftField();
   G4double global_active_zpos = active_zpos_ - GetELzCoord();
-  field->SetCathodePosition(global_active_zpos + active_length_/2.);
-  field->SetAnodePosition(global_active_zpos - active_length_/2.);
-  field->SetDriftVelocity(1. * mm/microsecond);
-  field->SetTransverseDiffusion(drift_transv_diff_);
-  field->SetLongitudinalDiffusion(drift_long_diff_);
   G4Region* drift_region = new G4Region("DRIFT");
-  drift_region->SetUserInformation(field);
+  if (drift_field_map_ != "") {
+    RadiusDependentDriftField* field =
+      new RadiusDependentDriftField(global_active_zpos - active_length_/2.,
+                                    global_active_zpos + active_length_/2.);
+    field->LoadFieldMap(drift_field_map_);
+    drift_region->SetUserInformation(field);
+  }
+  else {
+    UniformElectricDriftField* field = new UniformElectricDriftField();
+    field->SetCathodePosition(global_active_zpos + active_length_/2.);
+    field->SetAnodePosition(global_active_zpos - active_length_/2.);
+    field->SetDriftVelocity(1. * mm/microsecond);
+    field->SetTransverseDiffusion(drift_transv_diff_);
+    field->SetLongitudinalDiffusion(drift_long_diff_);
+    drift_region->SetUserInformation(field);
+  }
   drift_region->AddRootLogicalVolume(active_logic);
 
 
@@ -914,8 +927,50 @@ void Next100FieldCage::BuildFieldCage()
 }
 
 
+void Next100FieldCage::BuildVertexSamplers()
+{
+  // The cells of the samplers are classified with the
+  // navigator the first time a vertex is generated
+  active_cells_  = NewCellSampler(active_gen_,  {"ACTIVE"});
+  cathode_cells_ = NewCellSampler(cathode_gen_, {"CATHODE_RING"});
+  buffer_cells_  = NewCellSampler(buffer_gen_,  {"BUFFER"});
+  xenon_cells_   = NewCellSampler(xenon_gen_,   {"ACTIVE", "BUFFER", "EL_GAP"});
+  teflon_cells_  = NewCellSampler(teflon_gen_,
+                                  {"LIGHT_TUBE_DRIFT", "LIGHT_TUBE_BUFFER"});
+  hdpe_cells_    = NewCellSampler(hdpe_gen_,    {"HDPE_TUBE"});
+  el_gap_cells_  = NewCellSampler(el_gap_gen_,  {"EL_GAP"});
+  ring_cells_    = NewCellSampler(ring_gen_,    {"FIELD_RING"});
+  gate_cells_    = NewCellSampler(gate_gen_,    {"GATE_RING"});
+  anode_cells_   = NewCellSampler(anode_gen_,   {"ANODE_RING"});
+  holder_cells_  = NewCellSampler(holder_gen_,
+                                  {"ACT_HOLDER", "BUFF_HOLDER", "CATHODE_HOLDER"});
+}
+
+
+CellPointSampler*
+Next100FieldCage::NewCellSampler(CylinderPointSampler2020* gen,
+                                 const std::vector<G4String>& volumes) const
+{
+  auto map = [gen](G4double u_phi, G4double u_rad, G4double u_z) {
+    return gen->GetVolumePoint(u_phi, u_rad, u_z);
+  };
+  return new CellPointSampler(map, volumes, G4ThreeVector(0., 0., -GetELzCoord()));
+}
+
+
 Next100FieldCage::~Next100FieldCage()
 {
+  delete active_cells_;
+  delete buffer_cells_;
+  delete xenon_cells_;
+  delete teflon_cells_;
+  delete el_gap_cells_;
+  delete hdpe_cells_;
+  delete ring_cells_;
+  delete cathode_cells_;
+  delete gate_cells_;
+  delete anode_cells_;
+  delete holder_cells_;
   delete active_gen_;
   delete buffer_gen_;
   delete xenon_gen_;
@@ -932,146 +987,37 @@ Next100FieldCage::~Next100FieldCage()
 
 G4ThreeVector Next100FieldCage::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vertex(0., 0., 0.);
-
-  if (region == "CENTER") {
-    vertex = G4ThreeVector(0., 0., active_zpos_);
-  }
-
-  else if (region == "ACTIVE") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = active_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "CATHODE_RING") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = cathode_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "BUFFER") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = buffer_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "XENON") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = xenon_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (
-    VertexVolume->GetName() != "ACTIVE" &&
-    VertexVolume->GetName() != "BUFFER" &&
-    VertexVolume->GetName() != "EL_GAP");
-  }
-
-  else if (region == "LIGHT_TUBE") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = teflon_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (
-    VertexVolume->GetName() != "LIGHT_TUBE_DRIFT" &&
-    VertexVolume->GetName() != "LIGHT_TUBE_BUFFER" );
-  }
-
-  else if (region == "HDPE_TUBE") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = hdpe_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
+  return ResolveVertexRegion(region)();
+}
 
-  else if (region == "EL_GAP") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = el_gap_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
 
-  else if (region == "FIELD_RING") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = ring_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "GATE_RING") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = gate_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
-  }
-
-  else if (region == "ANODE_RING") {
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = anode_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while (VertexVolume->GetName() != region);
+GeometryBase::VertexRegion
+Next100FieldCage::ResolveVertexRegion(const G4String& region) const
+{
+  if (region == "CENTER") {
+    G4ThreeVector center(0., 0., active_zpos_);
+    return [center]() { return center; };
   }
 
-  else if (region == "RING_HOLDER"){
-    G4VPhysicalVolume *VertexVolume;
-    do {
-      vertex = holder_gen_->GenerateVertex("VOLUME");
-      G4ThreeVector glob_vtx(vertex);
-      glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-      VertexVolume =
-        geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
-    } while ((VertexVolume->GetName() != "ACT_HOLDER")  &&
-             (VertexVolume->GetName() != "BUFF_HOLDER") &&
-             (VertexVolume->GetName() != "CATHODE_HOLDER"));
- }
-
+  CellPointSampler* cells = nullptr;
+
+  if      (region == "ACTIVE")       cells = active_cells_;
+  else if (region == "CATHODE_RING") cells = cathode_cells_;
+  else if (region == "BUFFER")       cells = buffer_cells_;
+  else if (region == "XENON")        cells = xenon_cells_;
+  else if (region == "LIGHT_TUBE")   cells = teflon_cells_;
+  else if (region == "HDPE_TUBE")    cells = hdpe_cells_;
+  else if (region == "EL_GAP")       cells = el_gap_cells_;
+  else if (region == "FIELD_RING")   cells = ring_cells_;
+  else if (region == "GATE_RING")    cells = gate_cells_;
+  else if (region == "ANODE_RING")   cells = anode_cells_;
+  else if (region == "RING_HOLDER")  cells = holder_cells_;
   else {
-    G4Exception("[Next100FieldCage]", "GenerateVertex()", FatalException,
+    G4Exception("[Next100FieldCage]", "ResolveVertexRegion()", FatalException,
     "Unknown vertex generation region!");
   }
 
-  return vertex;
+  return [cells]() { return cells->Shoot(); };
 }
 
 
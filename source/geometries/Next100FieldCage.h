@@ -21,6 +21,7 @@ class G4Navigator;
 namespace nexus {
 
   class CylinderPointSampler2020;
+  class CellPointSampler;
 
 
   class Next100FieldCage: public GeometryBase
@@ -45,6 +46,14 @@ namespace nexus {
     void BuildELRegion();
     void BuildLightTube();
     void BuildFieldCage();
+    void BuildVertexSamplers();
+
+    VertexRegion ResolveVertexRegion(const G4String& region) const override;
+
+    /// Sampler of the points of a cylindrical region that lie
+    /// inside the physical volumes with the names given
+    CellPointSampler* NewCellSampler(CylinderPointSampler2020*,
+                                     const std::vector<G4String>&) const;
 
     // Dimensions
     G4double gate_sapphire_wdw_dist_;
@@ -61,6 +70,7 @@ namespace nexus {
 
     // Diffusion constants
     G4double drift_transv_diff_, drift_long_diff_;
+    G4String drift_field_map_; ///< (r,z) map of the drift field, if any
     G4double ELtransv_diff_; ///< transversal diffusion in the EL gap
     G4double ELlong_diff_; ///< longitudinal diffusion in the EL gap
     // Electric field
@@ -98,8 +108,18 @@ namespace nexus {
     CylinderPointSampler2020* anode_gen_;
     CylinderPointSampler2020* holder_gen_;
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
+    // Samplers restricted to the volumes of every region
+    CellPointSampler* active_cells_;
+    CellPointSampler* buffer_cells_;
+    CellPointSampler* teflon_cells_;
+    CellPointSampler* xenon_cells_;
+    CellPointSampler* el_gap_cells_;
+    CellPointSampler* hdpe_cells_;
+    CellPointSampler* ring_cells_;
+    CellPointSampler* cathode_cells_;
+    CellPointSampler* gate_cells_;
+    CellPointSampler* anode_cells_;
+    CellPointSampler* holder_cells_;
 
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
@@ -57,9 +57,6 @@ namespace nexus {
     // Vertex generator
     CylinderPointSampler2020* ics_gen_;
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
-
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
 
@@ -93,8 +93,13 @@ namespace nexus {
 
   G4ThreeVector Next100InnerElements::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
+    return ResolveVertexRegion(region)();
+  }
+
 
+  GeometryBase::VertexRegion
+  Next100InnerElements::ResolveVertexRegion(const G4String& region) const
+  {
     // Field Cage regions
     if ((region == "CENTER") ||
         (region == "ACTIVE") ||
@@ -108,7 +113,7 @@ namespace nexus {
         (region == "GATE_RING") ||
         (region == "ANODE_RING") ||
         (region == "RING_HOLDER")) {
-      vertex = field_cage_->GenerateVertex(region);
+      return field_cage_->GetVertexRegion(region);
     }
     // Energy Plane regions
     else if ((region == "EP_COPPER_PLATE") ||
@@ -117,20 +122,18 @@ namespace nexus {
              (region == "PMT") ||
              (region == "PMT_BODY") ||
              (region == "PMT_BASE")) {
-      vertex = energy_plane_->GenerateVertex(region);
+      return energy_plane_->GetVertexRegion(region);
     }
     // Tracking Plane regions
     else if ((region == "TP_COPPER_PLATE") ||
              (region == "SIPM_BOARD") ||
              (region == "DB_PLUG")) {
-      vertex = tracking_plane_->GenerateVertex(region);
-    }
-    else {
-      G4Exception("[Next100InnerElements]", "GenerateVertex()", FatalException,
-        "Unknown vertex generation region!");
+      return tracking_plane_->GetVertexRegion(region);
     }
 
-    return vertex;
+    G4Exception("[Next100InnerElements]", "ResolveVertexRegion()", FatalException,
+      "Unknown vertex generation region!");
+    return VertexRegion();
   }
 
 } // end namespace nexus
@@ -52,6 +52,9 @@ namespace nexus {
     void Construct();
 
 
+  private:
+    VertexRegion ResolveVertexRegion(const G4String& region) const;
+
   private:
 
     G4double gate_sapphire_wdw_distance_;
@@ -80,9 +80,6 @@ namespace nexus {
     msg_->DeclareProperty("shielding_vis", visibility_, "Shielding Visibility");
     msg_->DeclareProperty("shielding_verbosity", verbosity_, "Verbosity");
 
-    // Initializing the geometry navigator (used in vertex generation)
-    geom_navigator_ = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
-
   }
 
 
@@ -583,7 +580,7 @@ namespace nexus {
           	vertex = lead_gen_->GenerateVertex("WHOLE_VOL");
           	G4ThreeVector glob_vtx(vertex);
           	glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-          	VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+          	VertexVolume = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->LocateGlobalPointAndSetup(glob_vtx, 0, false);
         } while (VertexVolume->GetName() != "LEAD_BOX");
     }
 
@@ -593,7 +590,7 @@ namespace nexus {
           vertex = steel_gen_->GenerateVertex("WHOLE_VOL");
           G4ThreeVector glob_vtx(vertex);
           glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-          VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+          VertexVolume = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->LocateGlobalPointAndSetup(glob_vtx, 0, false);
       } while (VertexVolume->GetName() != "STEEL_BOX");
     }
 
@@ -603,7 +600,7 @@ namespace nexus {
           vertex = inner_air_gen_->GenerateVertex("INSIDE");
           G4ThreeVector glob_vtx(vertex);
           glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
-          VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+          VertexVolume = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->LocateGlobalPointAndSetup(glob_vtx, 0, false);
       } while (VertexVolume->GetName() != "INNER_AIR");
     }
 
@@ -107,9 +107,6 @@ namespace nexus {
     G4double perc_edpm_lateral_vol_;
 
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
-
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
 
@@ -45,9 +45,6 @@ Next100TrackingPlane::Next100TrackingPlane():
 
   msg_->DeclareProperty("tracking_plane_vis", visibility_,
                         "Visibility of the tracking plane volumes.");
-
-  geom_navigator_ =
-                  G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
 }
 
 
@@ -213,7 +210,7 @@ G4ThreeVector Next100TrackingPlane::GenerateVertex(const G4String& region) const
         G4ThreeVector glob_vtx(vertex);
         glob_vtx = glob_vtx + G4ThreeVector(0, 0, -GetELzCoord());
         VertexVolume =
-          geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+          G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->LocateGlobalPointAndSetup(glob_vtx, 0, false);
 
       } while ((VertexVolume->GetName() == "SIPM_BOARD_MASK_HOLE")  ||
               (VertexVolume->GetName() == "SIPM_BOARD_MASK_WLS_HOLE"));
@@ -63,8 +63,6 @@ namespace nexus {
     G4VPhysicalVolume* mpv_; // Pointer to mother's physical volume
 
     G4GenericMessenger* msg_;
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
   };
 
   inline void Next100TrackingPlane::SetMotherPhysicalVolume(G4VPhysicalVolume* p)
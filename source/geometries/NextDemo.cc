@@ -96,28 +96,32 @@ void NextDemo::ConstructLab()
 
 G4ThreeVector NextDemo::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vtx;
+  return ResolveVertexRegion(region)();
+}
+
+
+GeometryBase::VertexRegion NextDemo::ResolveVertexRegion(const G4String& region) const
+{
+  VertexRegion vtx_region;
 
   if (region == "AD_HOC") {
-    vtx = specific_vertex_;
+    return [this]() { return specific_vertex_; };
   }
   else if (region == "CALIBRATION_SOURCE") {
-    vtx = vessel_geom_->GenerateVertex("CALIBRATION_SOURCE");
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance());
-    vtx = vtx + displacement;
+    vtx_region = vessel_geom_->GetVertexRegion("CALIBRATION_SOURCE");
   }
   else if ((region == "ACTIVE")  ||
            (region == "TP_PLATE") ||
            (region == "SIPM_BOARD") ||
            (region == "EL_GAP")) {
-    vtx = inner_geom_->GenerateVertex(region);
-    G4ThreeVector displacement = G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance());
-    vtx = vtx + displacement;
+    vtx_region = inner_geom_->GetVertexRegion(region);
   }
   else {
-    G4Exception("[NextDemo]", "GenerateVertex()", FatalException,
+    G4Exception("[NextDemo]", "ResolveVertexRegion()", FatalException,
                 "Unknown vertex generation region.");
   }
 
-  return vtx;
+  G4ThreeVector displacement = G4ThreeVector(0., 0., -vessel_geom_->GetGateEndcapDistance());
+
+  return [vtx_region, displacement]() { return vtx_region() + displacement; };
 }
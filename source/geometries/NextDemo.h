@@ -29,6 +29,7 @@ namespace nexus {
 
   private:
     void ConstructLab();
+    VertexRegion ResolveVertexRegion(const G4String& region) const override;
 
   private:
     const G4double lab_size_;
@@ -57,8 +57,6 @@ namespace nexus {
 
   private:
 
-    G4Navigator* geom_navigator_;
-
     // Configuration
     G4String config_;
 
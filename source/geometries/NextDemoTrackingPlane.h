@@ -63,8 +63,6 @@ namespace nexus {
 
     G4GenericMessenger* msg_;
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
   };
 
   inline void NextDemoTrackingPlane::SetConfig(G4String config)
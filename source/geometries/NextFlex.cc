@@ -291,15 +291,20 @@ void NextFlex::BuildICS(G4LogicalVolume* mother_logic) {
 
 G4ThreeVector NextFlex::GenerateVertex(const G4String& region) const
 {
-  G4ThreeVector vertex;
+  return ResolveVertexRegion(region)();
+}
+
+
 
+GeometryBase::VertexRegion NextFlex::ResolveVertexRegion(const G4String& region) const
+{
   if (region == "AD_HOC") {
-    vertex = specific_vertex_;
+    return [this]() { return specific_vertex_; };
   }
 
   // ICS region
   else if (region == "ICS") {
-    vertex = copper_gen_->GenerateVertex("VOLUME");
+    return [this]() { return copper_gen_->GenerateVertex("VOLUME"); };
   }
 
   // Field Cage regions
@@ -309,26 +314,23 @@ G4ThreeVector NextFlex::GenerateVertex(const G4String& region) const
     (region == "EL_GAP") ||
     (region == "LIGHT_TUBE") ||
     (region == "FIBER_CORE")) {
-    vertex = field_cage_->GenerateVertex(region);
+    return field_cage_->GetVertexRegion(region);
   }
 
   // Energy Plane regions
   else if (
     (region == "EP_COPPER") ||
     (region == "EP_WINDOWS")) {
-    vertex = energy_plane_->GenerateVertex(region);
+    return energy_plane_->GetVertexRegion(region);
   }
 
   // Tracking Plane regions
   else if (
     (region == "TP_COPPER")) {
-    vertex = tracking_plane_->GenerateVertex(region);
-  }
-
-  else {
-    G4Exception("[NextFlex]", "GenerateVertex()", FatalException,
-      "Unknown vertex generation region!");
+    return tracking_plane_->GetVertexRegion(region);
   }
 
-  return vertex;
+  G4Exception("[NextFlex]", "ResolveVertexRegion()", FatalException,
+    "Unknown vertex generation region!");
+  return VertexRegion();
 }
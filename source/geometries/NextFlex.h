@@ -57,6 +57,9 @@ namespace nexus {
     // Different builders
     void BuildICS(G4LogicalVolume* mother_logic);
 
+    // Resolves the vertex generation regions
+    VertexRegion ResolveVertexRegion(const G4String& region) const;
+
   private:
 
     const G4int FIRST_ENERGY_SENSOR_ID      =      0;
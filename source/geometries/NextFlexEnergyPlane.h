@@ -97,9 +97,6 @@ namespace nexus {
     // The messenger
     G4GenericMessenger* msg_; // Messenger for configuration parameters
 
-   // Geometry Navigator
-    G4Navigator* geom_navigator_;
-
     // Energy Plane Configuration
     G4bool ep_with_PMTs_;    // PMTs arranged ala NEXT100
     G4bool ep_with_teflon_;  // Teflon mask to reflect light
@@ -97,9 +97,6 @@ namespace nexus {
     // The messenger
     G4GenericMessenger* msg_; // Messenger for configuration parameters
 
-   // Geometry Navigator
-    G4Navigator* geom_navigator_;
-
     // Materials & Components
     G4Material* xenon_gas_;
     G4Material* copper_mat_;
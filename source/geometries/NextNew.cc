@@ -449,70 +449,84 @@ namespace nexus {
 
   G4ThreeVector NextNew::GenerateVertex(const G4String& region) const
   {
-    G4ThreeVector vertex(0.,0.,0.);
+    return ResolveVertexRegion(region)();
+  }
+
+
+  GeometryBase::VertexRegion
+  NextNew::ResolveVertexRegion(const G4String& region) const
+  {
+    VertexRegion vertex_region;
 
     //AIR AROUND SHIELDING
     if (region == "LAB") {
-      vertex = lab_gen_->GenerateVertex("INSIDE");
+      vertex_region = [this]() { return lab_gen_->GenerateVertex("INSIDE"); };
     }
     /// Calibration source in capsule, placed inside Jordi's lead,
     /// at the end (lateral and axial ports).
     else if (region == "EXTERNAL_PORT_ANODE") {
-      if (lead_block_) {
-        vertex =  lat_source_gen_->GenerateVertex("BODY_VOL");
-      } else {
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+      if (!lead_block_) {
+        G4Exception("[NextNew]", "ResolveVertexRegion()", FatalException,
                     "This vertex generation region must be used together with lead_block == true!");
       }
+      vertex_region = [this]() { return lat_source_gen_->GenerateVertex("BODY_VOL"); };
     }
     else if (region == "EXTERNAL_PORT_AXIAL") {
-      if (lead_block_) {
-        vertex =  axial_source_gen_->GenerateVertex("BODY_VOL");
-      } else {
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+      if (!lead_block_) {
+        G4Exception("[NextNew]", "ResolveVertexRegion()", FatalException,
                     "This vertex generation region must be used together with lead_block == true!");
       }
+      vertex_region = [this]() { return axial_source_gen_->GenerateVertex("BODY_VOL"); };
     }
     // Vertex just outside the axial port
     else if (region == "SOURCE_PORT_AXIAL_EXT") {
-      vertex = vessel_->GetAxialExtSourcePosition();
+      G4ThreeVector vertex = vessel_->GetAxialExtSourcePosition();
+      vertex_region = [vertex]() { return vertex; };
     }
     // Vertex just outside the lateral port
     else if (region == "SOURCE_PORT_LATERAL_EXT") {
-      vertex = vessel_->GetLatExtSourcePosition();
+      G4ThreeVector vertex = vessel_->GetLatExtSourcePosition();
+      vertex_region = [vertex]() { return vertex; };
     }
     // Extended sources with the shape of a disk outside port
     else if (region == "SOURCE_PORT_LATERAL_DISK") {
-      vertex =  source_gen_lat_->GenerateVertex("BODY_VOL");
+      vertex_region = [this]() { return source_gen_lat_->GenerateVertex("BODY_VOL"); };
     }
     else if (region == "SOURCE_PORT_UP_DISK") {
-      vertex =  source_gen_up_->GenerateVertex("BODY_VOL");
+      vertex_region = [this]() { return source_gen_up_->GenerateVertex("BODY_VOL"); };
     }
      else if (region == "SOURCE_DISK") {
-      vertex =  source_gen_random_->GenerateVertex("BODY_VOL");
+      vertex_region = [this]() { return source_gen_random_->GenerateVertex("BODY_VOL"); };
     }
     else if ( (region == "SHIELDING_LEAD") || (region == "SHIELDING_STEEL") ||
 	          (region == "INNER_AIR")  || (region == "SHIELDING_STRUCT") ||
 	          (region == "EXTERNAL") ) {
-      vertex = shielding_->GenerateVertex(region);
+      vertex_region = shielding_->GetVertexRegion(region);
     }
     //PEDESTAL
     else if (region == "PEDESTAL_BOARD") {
-      vertex = pedestal_->GenerateVertex(region);
+      vertex_region = pedestal_->GetVertexRegion(region);
     }
     // EXTRA ELEMENTS
     else if (region == "EXTRA_VESSEL") {
-      G4ThreeVector ini_vertex = extra_->GenerateVertex(region);
-      ini_vertex.rotate(pi/2., G4ThreeVector(1., 0., 0.));
-      vertex = ini_vertex + extra_pos_;
+      VertexRegion extra_region = extra_->GetVertexRegion(region);
+      G4ThreeVector extra_pos = extra_pos_;
+      vertex_region = [extra_region, extra_pos]() {
+        G4ThreeVector ini_vertex = extra_region();
+        ini_vertex.rotate(pi/2., G4ThreeVector(1., 0., 0.));
+        return ini_vertex + extra_pos;
+      };
     }
     // Lab walls
     else if ((region == "HALLA_INNER") || (region == "HALLA_OUTER")){
       if (!lab_walls_)
-        G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+        G4Exception("[NextNew]", "ResolveVertexRegion()", FatalException,
                     "This vertex generation region must be used with lab_walls == true!");
-      vertex = hallA_walls_->GenerateVertex(region);
-      vertex = displ_ + vertex;
+      // The LSC HallA vertices are already corrected, so they are
+      // only shifted
+      VertexRegion hallA_region = hallA_walls_->GetVertexRegion(region);
+      G4ThreeVector displ = displ_;
+      return [hallA_region, displ]() { return displ + hallA_region(); };
     }
 
     //  MINI CASTLE and RADON
@@ -520,7 +534,7 @@ namespace nexus {
     else if ((region == "MINI_CASTLE") ||
              (region == "RN_MINI_CASTLE") ||
              (region == "MINI_CASTLE_STEEL")) {
-      vertex = mini_castle_->GenerateVertex(region);
+      vertex_region = mini_castle_->GetVertexRegion(region);
     }
     //VESSEL REGIONS
     else if ((region == "VESSEL") ||
@@ -530,11 +544,11 @@ namespace nexus {
              (region == "INTERNAL_PORT_ANODE") ||
              (region == "INTERNAL_PORT_UPPER") ||
              (region == "INTERNAL_PORT_AXIAL")){
-      vertex = vessel_->GenerateVertex(region);
+      vertex_region = vessel_->GetVertexRegion(region);
     }
     // ICS REGIONS
     else if (region == "ICS") {
-      vertex = ics_->GenerateVertex(region);
+      vertex_region = ics_->GetVertexRegion(region);
     }
     //INNER ELEMENTS
     else if ((region == "CENTER") ||
@@ -559,42 +573,44 @@ namespace nexus {
              (region == "SUPPORT_PLATE") ||
              (region == "DICE_BOARD") ||
              (region == "DB_PLUG")) {
-      vertex = inner_elements_->GenerateVertex(region);
+      vertex_region = inner_elements_->GetVertexRegion(region);
     }
     // AD_HOC is not rotated and shifted because it is passed by the user
     else if (region == "AD_HOC") {
-      return specific_vertex_;
+      return [this]() { return specific_vertex_; };
     }
     else {
-      G4Exception("[NextNew]", "GenerateVertex()", FatalException,
+      G4Exception("[NextNew]", "ResolveVertexRegion()", FatalException,
 		  "Unknown vertex generation region!");
     }
 
-    // The LSC HallA vertices are already corrected so no need.
-    if ((region == "HALLA_OUTER") ||
-        (region == "HALLA_INNER"))
-      return vertex;
+    G4double rot_angle = rot_angle_;
+    G4ThreeVector displ = displ_;
 
     // In EL_GAP, x and y coordinates are passed by the user,
     // but the z coordinate is not. Therefore, rotation + displacement
     // must be applied to get the correct z, but x and y must be left
     // unchanged.
     if (region == "EL_GAP") {
-      // First rotate, then shift to return the correct z coordinate
-      vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
-      vertex = vertex + displ_;
+      return [vertex_region, rot_angle, displ]() {
+        // First rotate, then shift to return the correct z coordinate
+        G4ThreeVector vertex = vertex_region();
+        vertex.rotate(rot_angle, G4ThreeVector(0., 1., 0.));
+        vertex = vertex + displ;
 
-      // Change back x coordinate alone (y is not touched).
-      vertex.setX(-vertex.x());
+        // Change back x coordinate alone (y is not touched).
+        vertex.setX(-vertex.x());
 
-      return vertex;
+        return vertex;
+      };
     }
 
     // First rotate, then shift
-    vertex.rotate(rot_angle_, G4ThreeVector(0., 1., 0.));
-    vertex = vertex + displ_;
-
-    return vertex;
+    return [vertex_region, rot_angle, displ]() {
+      G4ThreeVector vertex = vertex_region();
+      vertex.rotate(rot_angle, G4ThreeVector(0., 1., 0.));
+      return vertex + displ;
+    };
   }
 
 
@@ -49,6 +49,7 @@ namespace nexus {
   private:
     void BuildExtScintillator(G4ThreeVector pos, const G4RotationMatrix& rot);
     void Construct();
+    VertexRegion ResolveVertexRegion(const G4String& region) const;
 
   private:
 
@@ -54,8 +54,6 @@ namespace nexus {
     visibility_(1)
 
   {
-    /// Initializing the geometry navigator (used in vertex generation)
-    geom_navigator_ = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
     /// Messenger
     msg_ = new G4GenericMessenger(this, "/Geometry/NextNew/", "Control commands of geometry NextNewEnergyPlane.");
     msg_->DeclareProperty("energy_plane_vis", visibility_, "Energy Plane Visibility");
@@ -217,7 +215,7 @@ namespace nexus {
 	G4ThreeVector glob_vtx(vertex);
 	CalculateGlobalPos(glob_vtx);
 	VertexVolume =
-	  geom_navigator_->LocateGlobalPointAndSetup(glob_vtx, 0, false);
+	  G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->LocateGlobalPointAndSetup(glob_vtx, 0, false);
       } while (VertexVolume->GetName() != "CARRIER_PLATE");
     }
     //NextNewPmtEnclosures
@@ -75,8 +75,6 @@ namespace nexus {
     // Vertex generators
     CylinderPointSampler* carrier_gen_;
 
-    // Geometry Navigator
-    G4Navigator* geom_navigator_;
     // Messenger for the definition of control commands
     G4GenericMessenger* msg_;
   };
@@ -0,0 +1,34 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-eltable.cc
+//
+// Converts an EL light table from text to the binary format that
+// ELLookupTable maps directly into memory.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ELLookupTable.h"
+
+#include <G4ios.hh>
+
+
+void PrintUsage()
+{
+  G4cerr << "\nUsage: ./nexus-eltable <input text table> <output binary table>\n"
+         << G4endl;
+}
+
+
+int main(int argc, char** argv)
+{
+  if (argc != 3) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  nexus::ELLookupTable table(argv[1]);
+  table.Print();
+  table.WriteBinaryFile(argv[2]);
+
+  return EXIT_SUCCESS;
+}
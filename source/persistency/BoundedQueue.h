@@ -0,0 +1,150 @@
+// ----------------------------------------------------------------------------
+// nexus | BoundedQueue.h
+//
+// Fixed-capacity, lock-free queue for many producers and consumers,
+// built on a ring of cells tagged with sequence numbers. Producers and
+// consumers never block: TryPush and TryPop return false when the
+// queue is full or empty, respectively, and the caller decides how
+// to wait.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+
+namespace nexus {
+
+  template <typename T>
+  class BoundedQueue
+  {
+  public:
+    /// Constructor. The capacity is rounded up to a power of two.
+    BoundedQueue(std::size_t capacity);
+    /// Destructor
+    ~BoundedQueue() = default;
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /// Append an element to the queue. Returns false if it is full.
+    bool TryPush(T item);
+    /// Take the oldest element out of the queue. Returns false if it is empty.
+    bool TryPop(T& item);
+
+    /// Approximate number of elements in the queue
+    std::size_t Size() const;
+    /// Maximum number of elements the queue can hold
+    std::size_t Capacity() const;
+
+  private:
+    struct Cell {
+      std::atomic<std::size_t> sequence;
+      T data;
+    };
+
+    std::unique_ptr<Cell[]> buffer_;
+    std::size_t mask_;
+
+    // Kept in separate cache lines so that producers and
+    // consumers do not invalidate each other's position
+    alignas(64) std::atomic<std::size_t> enqueue_pos_;
+    alignas(64) std::atomic<std::size_t> dequeue_pos_;
+  };
+
+
+  template <typename T>
+  BoundedQueue<T>::BoundedQueue(std::size_t capacity):
+    enqueue_pos_(0), dequeue_pos_(0)
+  {
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    buffer_.reset(new Cell[size]);
+    mask_ = size - 1;
+
+    for (std::size_t i=0; i<size; ++i)
+      buffer_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+
+  template <typename T>
+  bool BoundedQueue<T>::TryPush(T item)
+  {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Cell& cell = buffer_[pos & mask_];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+
+      if (diff == 0) {
+        // The cell is free: try to claim it
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          cell.data = std::move(item);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0) {
+        // The cell still holds an element from the previous lap
+        return false;
+      }
+      else {
+        // Another producer claimed the cell first
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+
+  template <typename T>
+  bool BoundedQueue<T>::TryPop(T& item)
+  {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Cell& cell = buffer_[pos & mask_];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          item = std::move(cell.data);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+
+  template <typename T>
+  inline std::size_t BoundedQueue<T>::Size() const
+  {
+    std::size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+    std::size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+    return (tail > head) ? tail - head : 0;
+  }
+
+
+  template <typename T>
+  inline std::size_t BoundedQueue<T>::Capacity() const
+  { return mask_ + 1; }
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// nexus | EventOutputBlock.h
+//
+// Everything that is written to file for one event. Blocks are filled
+// by the thread that simulated the event and handed over to the output
+// writer thread, which assigns the event number and writes the rows.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EVENT_OUTPUT_BLOCK_H
+#define EVENT_OUTPUT_BLOCK_H
+
+#include <G4Types.hh>
+
+#include <string>
+#include <vector>
+#include <utility>
+
+
+namespace nexus {
+
+  struct EventOutputBlock
+  {
+    struct Particle {
+      G4int particle_id;
+      std::string name;
+      char primary;
+      G4int mother_id;
+      float initial_x, initial_y, initial_z, initial_t;
+      float final_x, final_y, final_z, final_t;
+      std::string initial_volume;
+      std::string final_volume;
+      float initial_momentum_x, initial_momentum_y, initial_momentum_z;
+      float final_momentum_x, final_momentum_y, final_momentum_z;
+      float kin_energy;
+      float length;
+      std::string creator_proc;
+      std::string final_proc;
+    };
+
+    struct Hit {
+      G4int particle_id;
+      G4int hit_id;
+      float x, y, z;
+      float time;
+      float energy;
+      std::string label;
+    };
+
+    struct SensorSample {
+      unsigned int sensor_id;
+      unsigned int time_bin;
+      unsigned int charge;
+    };
+
+    struct SensorPosition {
+      unsigned int sensor_id;
+      std::string name;
+      float x, y, z;
+    };
+
+    struct Step {
+      G4int particle_id;
+      std::string particle_name;
+      G4int step_id;
+      std::string initial_volume;
+      std::string final_volume;
+      std::string proc_name;
+      float initial_x, initial_y, initial_z;
+      float final_x, final_y, final_z;
+    };
+
+    G4int event_id = 0;        ///< Geant4 event ID, used for ordering
+    G4bool store = false;      ///< Should the event be written?
+    G4bool interacting = false; ///< Has the event interacted in ACTIVE?
+
+    std::vector<Particle> particles;
+    std::vector<Hit> hits;
+    std::vector<SensorSample> sensor_samples;
+    /// Sensors seen for the first time by the producing thread
+    std::vector<SensorPosition> sensor_positions;
+    std::vector<Step> steps;
+
+    /// Time binning of sensitive detectors seen for the first time
+    /// by the producing thread
+    std::vector<std::pair<std::string, G4double>> binnings;
+  };
+
+} // namespace nexus
+
+#endif
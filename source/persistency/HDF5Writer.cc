@@ -8,6 +8,8 @@
 
 #include "HDF5Writer.h"
 
+#include <globals.hh>
+
 #include <sstream>
 #include <cstring>
 #include <stdlib.h>
@@ -20,18 +22,25 @@ using namespace nexus;
 
 
 HDF5Writer::HDF5Writer():
-  file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0)
+  file_(0), useCodes_(false), irun_(0), ismp_(0), ihit_(0),
+  ipart_(0), ipos_(0), istep_(0), ievt_(0),
+  evtFirstSmp_(0), evtFirstHit_(0), evtFirstPart_(0), evtFirstStep_(0),
+  snsDataChunk_(CHUNKSIZE), hitInfoChunk_(CHUNKSIZE),
+  particleInfoChunk_(CHUNKSIZE), stepChunk_(CHUNKSIZE),
+  eventIndexChunk_(CHUNKSIZE)
 {
+  for (int i=0; i<NUM_STRING_TABLES; ++i) istr_[i] = 0;
 }
 
 HDF5Writer::~HDF5Writer()
 {
 }
 
-void HDF5Writer::Open(std::string fileName, bool debug)
+void HDF5Writer::Open(std::string fileName, bool debug, bool use_codes)
 {
   firstEvent_= true;
+  useCodes_ = use_codes;
+  tables_.clear();
 
   file_ = H5Fcreate( fileName.c_str(), H5F_ACC_TRUNC,
                       H5P_DEFAULT, H5P_DEFAULT );
@@ -45,15 +54,41 @@ void HDF5Writer::Open(std::string fileName, bool debug)
 
   std::string sns_data_table_name = "sns_response";
   memtypeSnsData_ = createSensorDataType();
-  snsDataTable_ = createTable(group, sns_data_table_name, memtypeSnsData_);
+  snsDataTable_ = CreateTable(group, sns_data_table_name, memtypeSnsData_,
+                              snsDataChunk_);
+  snsDataBuffer_.reserve(snsDataChunk_);
 
   std::string hit_info_table_name = "hits";
-  memtypeHitInfo_ = createHitInfoType();
-  hitInfoTable_ = createTable(group, hit_info_table_name, memtypeHitInfo_);
+  memtypeHitInfo_ = useCodes_ ? createHitCodeType() : createHitInfoType();
+  hitInfoTable_ = CreateTable(group, hit_info_table_name, memtypeHitInfo_,
+                              hitInfoChunk_);
 
   std::string particle_info_table_name = "particles";
-  memtypeParticleInfo_ = createParticleInfoType();
-  particleInfoTable_ = createTable(group, particle_info_table_name, memtypeParticleInfo_);
+  memtypeParticleInfo_ =
+    useCodes_ ? createParticleCodeType() : createParticleInfoType();
+  particleInfoTable_ = CreateTable(group, particle_info_table_name,
+                                   memtypeParticleInfo_, particleInfoChunk_);
+
+  if (useCodes_) {
+    hitCodeBuffer_.reserve(hitInfoChunk_);
+    particleCodeBuffer_.reserve(particleInfoChunk_);
+
+    std::string string_table_names[NUM_STRING_TABLES] =
+      {"particle_names", "volume_names", "process_names", "hit_labels"};
+    memtypeStringCode_ = createStringCodeType();
+    for (int i=0; i<NUM_STRING_TABLES; ++i)
+      stringTables_[i] =
+        createTable(group, string_table_names[i], memtypeStringCode_);
+  } else {
+    hitInfoBuffer_.reserve(hitInfoChunk_);
+    particleInfoBuffer_.reserve(particleInfoChunk_);
+  }
+
+  std::string event_index_table_name = "event_index";
+  memtypeEventIndex_ = createEventIndexType();
+  eventIndexTable_ = CreateTable(group, event_index_table_name,
+                                 memtypeEventIndex_, eventIndexChunk_);
+  eventIndexBuffer_.reserve(eventIndexChunk_);
 
   std::string sns_pos_table_name = "sns_positions";
   memtypeSnsPos_ = createSensorPosType();
@@ -63,19 +98,146 @@ void HDF5Writer::Open(std::string fileName, bool debug)
     std::string debug_group_name = "/DEBUG";
     size_t debug_group = createGroup(file_, debug_group_name);
     std::string step_table_name = "steps";
-    memtypeStep_ = createStepType();
-    stepTable_   = createTable(debug_group, step_table_name, memtypeStep_);
+    memtypeStep_ = useCodes_ ? createStepCodeType() : createStepType();
+    stepTable_   = CreateTable(debug_group, step_table_name, memtypeStep_,
+                               stepChunk_);
+    if (useCodes_) stepCodeBuffer_.reserve(stepChunk_);
+    else           stepBuffer_.reserve(stepChunk_);
   }
 
   isOpen_ = true;
 }
 
+void HDF5Writer::SetTableOptions(const std::string& table,
+                                 const table_options_t& options)
+{
+  tableOptions_[table] = options;
+}
+
+size_t HDF5Writer::CreateTable(size_t group, std::string name, size_t memtype,
+                               hsize_t& chunk_rows)
+{
+  table_options_t options;
+  auto it = tableOptions_.find(name);
+  if (it != tableOptions_.end()) options = it->second;
+
+  if (options.filter == "gzip" && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+    G4String msg = "The HDF5 library has no gzip filter. The table " + name +
+      " is written without compression.";
+    G4Exception("[HDF5Writer]", "CreateTable()", JustWarning, msg);
+    options.filter = "none";
+  }
+
+  chunk_rows = chunkRows(memtype, options);
+
+  // HDF5 does not allow chunks of 4 GB or more
+  const hsize_t max_chunk_bytes = (hsize_t(1) << 32) - 1;
+  if (chunk_rows > max_chunk_bytes / H5Tget_size(memtype)) {
+    G4String msg = "The chunks of the table " + name + " (" +
+      std::to_string(chunk_rows) + " rows) exceed the HDF5 limit of 4 GB.";
+    G4Exception("[HDF5Writer]", "CreateTable()", FatalException, msg);
+  }
+
+  size_t table = createTable(group, name, memtype, options);
+  tables_.push_back(std::make_pair(name, table));
+  return table;
+}
+
 void HDF5Writer::Close()
 {
+  Flush();
+
+  hsize_t total_raw = 0, total_stored = 0;
+  for (auto& t: tables_) {
+    hsize_t raw, stored;
+    getTableSize(t.second, raw, stored);
+    total_raw    += raw;
+    total_stored += stored;
+    std::cout << "[HDF5Writer] " << t.first << ": "
+              << raw << " bytes, " << stored << " bytes written";
+    if (stored > 0) std::cout << " (ratio " << (double)raw/stored << ")";
+    std::cout << std::endl;
+  }
+  std::cout << "[HDF5Writer] Total: " << total_raw << " bytes, "
+            << total_stored << " bytes written" << std::endl;
+
   isOpen_=false;
   H5Fclose(file_);
 }
 
+void HDF5Writer::Flush()
+{
+  FlushSensorData();
+  FlushHits();
+  FlushParticles();
+  FlushSteps();
+  FlushEventIndex();
+}
+
+void HDF5Writer::FlushSensorData()
+{
+  size_t nrows = snsDataBuffer_.size();
+  writeSnsData(snsDataBuffer_.data(), snsDataTable_, memtypeSnsData_,
+               ismp_ - nrows, nrows);
+  snsDataBuffer_.clear();
+}
+
+void HDF5Writer::FlushHits()
+{
+  if (useCodes_) {
+    size_t nrows = hitCodeBuffer_.size();
+    writeRows(hitCodeBuffer_.data(), hitInfoTable_, memtypeHitInfo_,
+              ihit_ - nrows, nrows);
+    hitCodeBuffer_.clear();
+    return;
+  }
+
+  size_t nrows = hitInfoBuffer_.size();
+  writeHit(hitInfoBuffer_.data(), hitInfoTable_, memtypeHitInfo_,
+           ihit_ - nrows, nrows);
+  hitInfoBuffer_.clear();
+}
+
+void HDF5Writer::FlushParticles()
+{
+  if (useCodes_) {
+    size_t nrows = particleCodeBuffer_.size();
+    writeRows(particleCodeBuffer_.data(), particleInfoTable_,
+              memtypeParticleInfo_, ipart_ - nrows, nrows);
+    particleCodeBuffer_.clear();
+    return;
+  }
+
+  size_t nrows = particleInfoBuffer_.size();
+  writeParticle(particleInfoBuffer_.data(), particleInfoTable_,
+                memtypeParticleInfo_, ipart_ - nrows, nrows);
+  particleInfoBuffer_.clear();
+}
+
+void HDF5Writer::FlushSteps()
+{
+  if (useCodes_) {
+    size_t nrows = stepCodeBuffer_.size();
+    writeRows(stepCodeBuffer_.data(), stepTable_, memtypeStep_,
+              istep_ - nrows, nrows);
+    stepCodeBuffer_.clear();
+    return;
+  }
+
+  size_t nrows = stepBuffer_.size();
+  writeStep(stepBuffer_.data(), stepTable_, memtypeStep_,
+            istep_ - nrows, nrows);
+  stepBuffer_.clear();
+}
+
+void HDF5Writer::FlushEventIndex()
+{
+  size_t nrows = eventIndexBuffer_.size();
+  writeRows(eventIndexBuffer_.data(), eventIndexTable_, memtypeEventIndex_,
+            ievt_ - nrows, nrows);
+  eventIndexBuffer_.clear();
+}
+
 void HDF5Writer::WriteRunInfo(const char* param_key, const char* param_value)
 {
   run_info_t runData;
@@ -96,9 +258,10 @@ void HDF5Writer::WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id,
   snsData.sensor_id = sensor_id;
   snsData.time_bin = time_bin;
   snsData.charge = charge;
-  writeSnsData(&snsData, snsDataTable_, memtypeSnsData_, ismp_);
+  snsDataBuffer_.push_back(snsData);
 
   ismp_++;
+  if (snsDataBuffer_.size() == snsDataChunk_) FlushSensorData();
 }
 
 void HDF5Writer::WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label)
@@ -114,9 +277,10 @@ void HDF5Writer::WriteHitInfo(int64_t evt_number, int particle_indx, int hit_ind
   strcpy(trueInfo.label, label);
   trueInfo.particle_id = particle_indx;
   trueInfo.hit_id = hit_indx;
-  writeHit(&trueInfo,  hitInfoTable_, memtypeHitInfo_, ihit_);
+  hitInfoBuffer_.push_back(trueInfo);
 
   ihit_++;
+  if (hitInfoBuffer_.size() == hitInfoChunk_) FlushHits();
 }
 
 void HDF5Writer::WriteParticleInfo(int64_t evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc)
@@ -152,9 +316,10 @@ void HDF5Writer::WriteParticleInfo(int64_t evt_number, int particle_indx, const
   strcpy(trueInfo.creator_proc, creator_proc);
   memset(trueInfo.final_proc, 0, STRLEN);
   strcpy(trueInfo.final_proc, final_proc);
-  writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
+  particleInfoBuffer_.push_back(trueInfo);
 
   ipart_++;
+  if (particleInfoBuffer_.size() == particleInfoChunk_) FlushParticles();
 }
 
 void HDF5Writer::WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z)
@@ -199,7 +364,90 @@ void HDF5Writer::WriteStep(int64_t evt_number,
   step.  final_y   =   final_y;
   step.  final_z   =   final_z;
 
-  writeStep(&step, stepTable_, memtypeStep_, istep_);
+  stepBuffer_.push_back(step);
 
   istep_++;
+  if (stepBuffer_.size() == stepChunk_) FlushSteps();
+}
+
+void HDF5Writer::WriteHitCodes(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, int label)
+{
+  hitCodeBuffer_.push_back({evt_number,
+                            hit_position_x, hit_position_y, hit_position_z,
+                            hit_time, hit_energy,
+                            label, particle_indx, hit_indx});
+
+  ihit_++;
+  if (hitCodeBuffer_.size() == hitInfoChunk_) FlushHits();
+}
+
+void HDF5Writer::WriteParticleCodes(int64_t evt_number, int particle_indx, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, int creator_proc, int final_proc)
+{
+  particleCodeBuffer_.push_back({evt_number, particle_indx, particle_name,
+                                 primary, mother_id,
+                                 initial_vertex_x, initial_vertex_y,
+                                 initial_vertex_z, initial_vertex_t,
+                                 final_vertex_x, final_vertex_y,
+                                 final_vertex_z, final_vertex_t,
+                                 initial_volume, final_volume,
+                                 ini_momentum_x, ini_momentum_y, ini_momentum_z,
+                                 final_momentum_x, final_momentum_y,
+                                 final_momentum_z,
+                                 kin_energy, length,
+                                 creator_proc, final_proc});
+
+  ipart_++;
+  if (particleCodeBuffer_.size() == particleInfoChunk_) FlushParticles();
+}
+
+void HDF5Writer::WriteStepCodes(int64_t evt_number,
+                                int particle_id, int particle_name,
+                                int step_id,
+                                int initial_volume,
+                                int   final_volume,
+                                int      proc_name,
+                                float initial_x, float initial_y, float initial_z,
+                                float   final_x, float   final_y, float   final_z)
+{
+  stepCodeBuffer_.push_back({evt_number, particle_id, particle_name, step_id,
+                             initial_volume, final_volume, proc_name,
+                             initial_x, initial_y, initial_z,
+                             final_x, final_y, final_z});
+
+  istep_++;
+  if (stepCodeBuffer_.size() == stepChunk_) FlushSteps();
+}
+
+void HDF5Writer::WriteEventIndex(int64_t evt_number)
+{
+  event_index_t index;
+  index.event_id           = evt_number;
+  index.hits_start         = evtFirstHit_;
+  index.hits_count         = ihit_ - evtFirstHit_;
+  index.particles_start    = evtFirstPart_;
+  index.particles_count    = ipart_ - evtFirstPart_;
+  index.sns_response_start = evtFirstSmp_;
+  index.sns_response_count = ismp_ - evtFirstSmp_;
+  index.steps_start        = evtFirstStep_;
+  index.steps_count        = istep_ - evtFirstStep_;
+  eventIndexBuffer_.push_back(index);
+
+  evtFirstSmp_  = ismp_;
+  evtFirstHit_  = ihit_;
+  evtFirstPart_ = ipart_;
+  evtFirstStep_ = istep_;
+
+  ievt_++;
+  if (eventIndexBuffer_.size() == eventIndexChunk_) FlushEventIndex();
+}
+
+void HDF5Writer::WriteStringCode(StringTable table, int code, const char* name)
+{
+  string_code_t entry;
+  entry.code = code;
+  memset(entry.name, 0, STRLEN);
+  strncpy(entry.name, name, STRLEN-1);
+  writeRows(&entry, stringTables_[table], memtypeStringCode_, istr_[table], 1);
+
+  istr_[table]++;
 }
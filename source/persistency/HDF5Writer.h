@@ -13,23 +13,40 @@
 
 #include <hdf5.h>
 #include <iostream>
+#include <vector>
+#include <map>
+#include <string>
 
 namespace nexus {
 
   class HDF5Writer {
 
+  public:
+    /// Tables defining the integer codes of the strings
+    /// written in the hits, particles and steps tables
+    enum StringTable { PARTICLE_NAMES, VOLUME_NAMES, PROCESS_NAMES,
+                       HIT_LABELS, NUM_STRING_TABLES };
+
   public:
     /// constructor
     HDF5Writer();
     /// destructor
     ~HDF5Writer();
 
-    /// open file
-    void Open(std::string filename, bool debug);
+    /// open file. If use_codes is true, the names in the hits,
+    /// particles and steps tables are replaced by integer codes.
+    void Open(std::string filename, bool debug, bool use_codes=false);
 
-    /// close file
+    /// Set the storage layout of a table (hits, particles,
+    /// sns_response or steps) before opening the file
+    void SetTableOptions(const std::string& table, const table_options_t& options);
+
+    /// close file, reporting the size of the tables
     void Close();
 
+    /// write all the buffered rows to file
+    void Flush();
+
     void WriteRunInfo(const char* param_key, const char* param_value);
     void WriteSensorDataInfo(int64_t evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
     void WriteHitInfo(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label);
@@ -44,11 +61,48 @@ namespace nexus {
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z);
 
+    // Same as above, with the names replaced by their codes
+    void WriteHitCodes(int64_t evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, int label);
+    void WriteParticleCodes(int64_t evt_number, int particle_indx, int particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, int initial_volume, int final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, int creator_proc, int final_proc);
+    void WriteStepCodes(int64_t evt_number,
+                        int particle_id, int particle_name,
+                        int step_id,
+                        int initial_volume,
+                        int   final_volume,
+                        int      proc_name,
+                        float initial_x, float initial_y, float initial_z,
+                        float   final_x, float   final_y, float   final_z);
+
+    /// write the rows of the tables taken by an event, which are
+    /// those written since the previous call
+    void WriteEventIndex(int64_t evt_number);
+
+    /// define the code of a string
+    void WriteStringCode(StringTable table, int code, const char* name);
+
+    bool UsesCodes() const;
+
+  private:
+    void FlushSensorData();
+    void FlushHits();
+    void FlushParticles();
+    void FlushSteps();
+    void FlushEventIndex();
+
+    /// create a table with the options set for it
+    size_t CreateTable(size_t group, std::string name, size_t memtype,
+                       hsize_t& chunk_rows);
+
   private:
     size_t file_; ///< HDF5 file
 
     bool isOpen_;
     bool firstEvent_; ///< First event
+    bool useCodes_; ///< Are names written as integer codes?
+
+    std::map<std::string, table_options_t> tableOptions_;
+    /// Tables in the file, by name, for the size report
+    std::vector<std::pair<std::string, size_t>> tables_;
 
     //Datasets
     size_t runTable_;
@@ -57,6 +111,7 @@ namespace nexus {
     size_t particleInfoTable_;
     size_t snsPosTable_;
     size_t stepTable_;
+    size_t eventIndexTable_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
@@ -64,6 +119,11 @@ namespace nexus {
     size_t memtypeParticleInfo_;
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
+    size_t memtypeStringCode_;
+    size_t memtypeEventIndex_;
+
+    size_t stringTables_[NUM_STRING_TABLES];
+    size_t istr_[NUM_STRING_TABLES]; ///< counters for string codes
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
@@ -71,9 +131,36 @@ namespace nexus {
     size_t ipart_; ///< counter for particle information
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
+    size_t ievt_; ///< counter for indexed events
+
+    // Counters at the start of the current event
+    size_t evtFirstSmp_;
+    size_t evtFirstHit_;
+    size_t evtFirstPart_;
+    size_t evtFirstStep_;
+
+    // Rows per chunk, which is also the number of rows
+    // buffered before writing to the table
+    hsize_t snsDataChunk_;
+    hsize_t hitInfoChunk_;
+    hsize_t particleInfoChunk_;
+    hsize_t stepChunk_;
+    hsize_t eventIndexChunk_;
+
+    // Rows waiting to be written, one chunk at a time
+    std::vector<sns_data_t> snsDataBuffer_;
+    std::vector<hit_info_t> hitInfoBuffer_;
+    std::vector<particle_info_t> particleInfoBuffer_;
+    std::vector<step_info_t> stepBuffer_;
+    std::vector<hit_code_t> hitCodeBuffer_;
+    std::vector<particle_code_t> particleCodeBuffer_;
+    std::vector<step_code_t> stepCodeBuffer_;
+    std::vector<event_index_t> eventIndexBuffer_;
 
   };
 
+  inline bool HDF5Writer::UsesCodes() const { return useCodes_; }
+
 } // namespace nexus
 
 #endif
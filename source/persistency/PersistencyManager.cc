@@ -2,7 +2,10 @@
 // nexus | PersistencyManager.cc
 //
 // This class writes all the relevant information of the simulation
-// to an ouput file.
+// to an ouput file. Every thread has its own instance, which packs the
+// output of each event in a block and hands it over to the master
+// instance through a bounded queue. A dedicated writer thread owned by
+// the master instance is the only one touching the output file.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,11 +16,11 @@
 #include "TrajectoryMap.h"
 #include "IonizationSD.h"
 #include "SensorSD.h"
-#include "NexusApp.h"
 #include "DetectorConstruction.h"
 #include "SaveAllSteppingAction.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
+#include "EventOutputBlock.h"
 #include "PersistencyManagerBase.h"
 #include "FactoryBase.h"
 
@@ -29,11 +32,14 @@
 #include <G4HCtable.hh>
 #include <G4RunManager.hh>
 #include <G4Run.hh>
+#include <G4AutoLock.hh>
+#include <G4Threading.hh>
 
 #include <string>
 #include <sstream>
 #include <iostream>
-#include <string>
+#include <algorithm>
+#include <chrono>
 
 using namespace nexus;
 
@@ -41,19 +47,78 @@ using namespace nexus;
 REGISTER_CLASS(PersistencyManager, PersistencyManagerBase)
 
 
+PersistencyManager* PersistencyManager::master_ = nullptr;
+
+namespace {
+  // Tables with configurable storage layout
+  const char* table_names[] = {"hits", "particles", "sns_response", "steps"};
+
+  // Serializes the start of the writer thread, which is
+  // triggered by the first event block of every run
+  G4Mutex writerMutex = G4MUTEX_INITIALIZER;
+}
+
+
 PersistencyManager::PersistencyManager():
   PersistencyManagerBase(), msg_(0), ready_(false),
   store_evt_(true), store_steps_(false),
   interacting_evt_(false), save_ie_numb_(false), event_type_("other"),
   saved_evts_(0), interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0)
+  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0),
+  queue_(0), writer_running_(false), queue_size_(64), strict_order_(true),
+  next_evt_id_(0), use_codes_(false),
+  stall_ns_(0), max_depth_(0), sum_depth_(0.), nblocks_(0)
 {
+  if (G4Threading::IsMasterThread()) master_ = this;
+
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
-  msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "");
+  // Only the master thread opens the output file
+  msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "")
+    .command->SetToBeBroadcasted(false);
   msg_->DeclareProperty("eventType", event_type_,
                         "Type of event: bb0nu, bb2nu, background.");
   msg_->DeclareProperty("start_id", start_id_,
                         "Starting event ID for this job.");
+  msg_->DeclareProperty("queue_size", queue_size_,
+                        "Number of event blocks waiting to be written before producers stall.");
+  msg_->DeclareProperty("strict_order", strict_order_,
+                        "Write events in order of event ID (true) or of arrival (false).");
+  msg_->DeclareProperty("string_codes", use_codes_,
+                        "Write particle, volume and process names as integer codes "
+                        "defined in separate tables. Must be set before outputFile.");
+
+  // Storage layout of the main tables, which must also be set before
+  // outputFile. By default, chunks are about 1 MB and compressed with gzip.
+  for (G4int i=0; i<num_tables_; ++i) {
+    G4String table = table_names[i];
+    chunk_size_[i]        = 0;
+    shuffle_[i]           = true;
+    compression_[i]       = "gzip";
+    compression_level_[i] = 4;
+
+    G4GenericMessenger::Command& chunk_cmd =
+      msg_->DeclareProperty(table + "_chunk_size", chunk_size_[i],
+                            "Rows per chunk of the " + table +
+                            " table (0: about 1 MB per chunk).");
+    chunk_cmd.SetParameterName(table + "_chunk_size", false);
+    chunk_cmd.SetRange(table + "_chunk_size>=0");
+
+    msg_->DeclareProperty(table + "_shuffle", shuffle_[i],
+                          "Shuffle the bytes of the " + table +
+                          " table before compressing.");
+
+    G4GenericMessenger::Command& comp_cmd =
+      msg_->DeclareProperty(table + "_compression", compression_[i],
+                            "Compression filter of the " + table + " table.");
+    comp_cmd.SetCandidates("none gzip");
+
+    G4GenericMessenger::Command& level_cmd =
+      msg_->DeclareProperty(table + "_compression_level", compression_level_[i],
+                            "Compression level of the " + table + " table.");
+    level_cmd.SetParameterName(table + "_compression_level", false);
+    level_cmd.SetRange(table + "_compression_level>=0 && " +
+                       table + "_compression_level<=9");
+  }
 
   init_macro_ = "";
   macros_.clear();
@@ -65,7 +130,10 @@ PersistencyManager::PersistencyManager():
 
 PersistencyManager::~PersistencyManager()
 {
+  StopWriter();
+  if (master_ == this) master_ = nullptr;
   delete msg_;
+  delete queue_;
   delete h5writer_;
 }
 
@@ -95,8 +163,18 @@ void PersistencyManager::OpenFile(G4String filename)
   // If the output file was not set yet, do so
   if (!h5writer_) {
     h5writer_ = new HDF5Writer();
+    for (G4int i=0; i<num_tables_; ++i) {
+      table_options_t options;
+      options.chunk_size = chunk_size_[i];
+      options.shuffle    = shuffle_[i];
+      options.filter     = compression_[i];
+      options.level      = compression_level_[i];
+      h5writer_->SetTableOptions(table_names[i], options);
+    }
     G4String hdf5file = filename + ".h5";
-    h5writer_->Open(hdf5file, store_steps_);
+    h5writer_->Open(hdf5file, store_steps_, use_codes_);
+    string_codes_.assign(HDF5Writer::NUM_STRING_TABLES,
+                         std::unordered_map<std::string, G4int>());
     return;
   } else {
     G4Exception("[PersistencyManager]", "OpenFile()",
@@ -110,6 +188,7 @@ void PersistencyManager::CloseFile()
 {
   if (!h5writer_) return;
 
+  StopWriter();
   h5writer_->Close();
 }
 
@@ -117,11 +196,15 @@ void PersistencyManager::CloseFile()
 
 G4bool PersistencyManager::Store(const G4Event* event)
 {
-  if (interacting_evt_) {
-    interacting_evts_++;
-  }
+  // Every event is handed over to the writer, even if it is not
+  // stored, so that the writer can keep track of the event order
+  EventOutputBlock* block = new EventOutputBlock();
+  block->event_id    = event->GetEventID();
+  block->interacting = interacting_evt_;
+  block->store       = store_evt_;
 
   if (!store_evt_) {
+    master_->Push(block);
     TrajectoryMap::Clear();
     if (store_steps_) {
       SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
@@ -131,23 +214,16 @@ G4bool PersistencyManager::Store(const G4Event* event)
     return false;
   }
 
-  saved_evts_++;
-
-  if (first_evt_) {
-    first_evt_ = false;
-    nevt_ = start_id_;
-  }
-
   if (store_steps_)
-    StoreSteps();
+    StoreSteps(*block);
 
   // Store the trajectories of the event
-  StoreTrajectories(event->GetTrajectoryContainer());
+  StoreTrajectories(event->GetTrajectoryContainer(), *block);
 
   // Store ionization hits and sensor hits
-  StoreHits(event->GetHCofThisEvent());
+  StoreHits(event->GetHCofThisEvent(), *block);
 
-  nevt_++;
+  master_->Push(block);
 
   TrajectoryMap::Clear();
   StoreCurrentEvent(true);
@@ -156,62 +232,65 @@ G4bool PersistencyManager::Store(const G4Event* event)
 }
 
 
-void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
+void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc,
+                                           EventOutputBlock& block)
 {
   // If the pointer is null, no trajectories were stored in this event
   if (!tc) return;
 
+  block.particles.reserve(tc->entries());
+
   // Loop through the trajectories stored in the container
   for (size_t i=0; i<tc->entries(); ++i) {
     Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
     if (!trj) continue;
 
-    G4int trackid = trj->GetTrackID();
-
-    G4double length = trj->GetTrackLength();
-
     G4ThreeVector ini_xyz = trj->GetInitialPosition();
-    G4double ini_t = trj->GetInitialTime();
-
     G4ThreeVector final_xyz = trj->GetFinalPosition();
-    G4double final_t = trj->GetFinalTime();
-
-    G4String ini_volume = trj->GetInitialVolume();
-    G4String final_volume = trj->GetFinalVolume();
 
     G4double mass = trj->GetParticleDefinition()->GetPDGMass();
     G4ThreeVector ini_mom = trj->GetInitialMomentum();
     G4double energy = sqrt(ini_mom.mag2() + mass*mass);
     G4ThreeVector final_mom = trj->GetFinalMomentum();
 
-    float kin_energy = energy - mass;
-    char primary = 0;
-    G4int mother_id = 0;
+    EventOutputBlock::Particle p;
+    p.particle_id = trj->GetTrackID();
+    p.name = trj->GetParticleName();
+    p.primary = 0;
+    p.mother_id = 0;
     if (!trj->GetParentID()) {
-      primary = 1;
+      p.primary = 1;
     } else {
-      mother_id = trj->GetParentID();
+      p.mother_id = trj->GetParentID();
     }
-    h5writer_->WriteParticleInfo(nevt_, trackid, trj->GetParticleName().c_str(),
-				 primary, mother_id,
-				 (float)ini_xyz.x(), (float)ini_xyz.y(),
-                                 (float)ini_xyz.z(), (float)ini_t,
-				 (float)final_xyz.x(), (float)final_xyz.y(),
-                                 (float)final_xyz.z(), (float)final_t,
-				 ini_volume.c_str(), final_volume.c_str(),
-				 (float)ini_mom.x(), (float)ini_mom.y(),
-                                 (float)ini_mom.z(), (float)final_mom.x(),
-                                 (float)final_mom.y(), (float)final_mom.z(),
-				 kin_energy, length,
-                                 trj->GetCreatorProcess().c_str(),
-				 trj->GetFinalProcess().c_str());
-
+    p.initial_x = ini_xyz.x();
+    p.initial_y = ini_xyz.y();
+    p.initial_z = ini_xyz.z();
+    p.initial_t = trj->GetInitialTime();
+    p.final_x = final_xyz.x();
+    p.final_y = final_xyz.y();
+    p.final_z = final_xyz.z();
+    p.final_t = trj->GetFinalTime();
+    p.initial_volume = trj->GetInitialVolume();
+    p.final_volume = trj->GetFinalVolume();
+    p.initial_momentum_x = ini_mom.x();
+    p.initial_momentum_y = ini_mom.y();
+    p.initial_momentum_z = ini_mom.z();
+    p.final_momentum_x = final_mom.x();
+    p.final_momentum_y = final_mom.y();
+    p.final_momentum_z = final_mom.z();
+    p.kin_energy = energy - mass;
+    p.length = trj->GetTrackLength();
+    p.creator_proc = trj->GetCreatorProcess();
+    p.final_proc = trj->GetFinalProcess();
+
+    block.particles.push_back(std::move(p));
   }
 }
 
 
 
-void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
+void PersistencyManager::StoreHits(G4HCofThisEvent* hce, EventOutputBlock& block)
 {
   if (!hce) return;
 
@@ -232,9 +311,9 @@ void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
     G4VHitsCollection* hits = hce->GetHC(hcid);
 
     if (hcname == IonizationSD::GetCollectionUniqueName())
-      StoreIonizationHits(hits);
+      StoreIonizationHits(hits, block);
     else if (hcname == SensorSD::GetCollectionUniqueName()) {
-      StoreSensorHits(hits);
+      StoreSensorHits(hits, block);
     } else {
       G4String msg =
         "Collection of hits '" + sdname + "/" + hcname
@@ -246,15 +325,16 @@ void PersistencyManager::StoreHits(G4HCofThisEvent* hce)
 }
 
 
-void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
+void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc,
+                                             EventOutputBlock& block)
 {
   IonizationHitsCollection* hits =
     dynamic_cast<IonizationHitsCollection*>(hc);
   if (!hits) return;
 
-  hit_map_.clear();
+  // Number of hits found so far for each track
+  std::map<G4int, G4int> hit_count;
 
-  double evt_energy = 0.;
   std::string sdname = hits->GetSDname();
 
   for (size_t i=0; i<hits->entries(); i++) {
@@ -264,43 +344,39 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
 
     G4int trackid = hit->GetTrackID();
 
-    std::vector<G4int>* ihits = nullptr;
-    std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
-    if (it != hit_map_.end()) {
-      ihits = it->second;
-    } else {
-       ihits = new std::vector<G4int>;
-      hit_map_[trackid] = ihits;
-    }
-
-    ihits->push_back(1);
-
     G4ThreeVector xyz = hit->GetPosition();
-    h5writer_->WriteHitInfo(nevt_, trackid,  ihits->size() - 1,
-			    xyz[0], xyz[1], xyz[2],
-			    hit->GetTime(), hit->GetEnergyDeposit(),
-			    sdname.c_str());
 
-    evt_energy += hit->GetEnergyDeposit();
+    EventOutputBlock::Hit h;
+    h.particle_id = trackid;
+    h.hit_id = hit_count[trackid]++;
+    h.x = xyz[0];
+    h.y = xyz[1];
+    h.z = xyz[2];
+    h.time = hit->GetTime();
+    h.energy = hit->GetEnergyDeposit();
+    h.label = sdname;
+
+    block.hits.push_back(std::move(h));
   }
 }
 
 
 
-void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
+void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc,
+                                         EventOutputBlock& block)
 {
   SensorHitsCollection* hits = dynamic_cast<SensorHitsCollection*>(hc);
   if (!hits) return;
 
   std::string sdname = hits->GetSDname();
 
-  std::map<G4String, G4double>::const_iterator sensdet_it = sensdet_bin_.find(sdname);
-  if (sensdet_it == sensdet_bin_.end()) {
+  if (known_sensdets_.find(sdname) == known_sensdets_.end()) {
     for (size_t j=0; j<hits->entries(); j++) {
       SensorHit* hit = dynamic_cast<SensorHit*>(hits->GetHit(j));
       if (!hit) continue;
       G4double bin_size = hit->GetBinSize();
-      sensdet_bin_[sdname] = bin_size;
+      block.binnings.push_back(std::make_pair(sdname, bin_size));
+      known_sensdets_.insert(sdname);
       break;
     }
   }
@@ -312,36 +388,28 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
 
     G4ThreeVector xyz = hit->GetPosition();
     G4double binsize = hit->GetBinSize();
+    unsigned int sensor_id = (unsigned int)hit->GetPmtID();
 
-    const std::map<G4double, G4int>& wvfm = hit->GetHistogram();
-    std::map<G4double, G4int>::const_iterator it;
-    std::vector< std::pair<unsigned int,float> > data;
-    G4double amplitude = 0.;
+    const SensorHit::Histogram wvfm = hit->GetHistogram();
 
-    for (it = wvfm.begin(); it != wvfm.end(); ++it) {
+    for (auto it = wvfm.begin(); it != wvfm.end(); ++it) {
       unsigned int time_bin = (unsigned int)((*it).first/binsize+0.5);
       unsigned int charge = (unsigned int)((*it).second+0.5);
 
-      data.push_back(std::make_pair(time_bin, charge));
-      amplitude = amplitude + (*it).second;
-
-      h5writer_->WriteSensorDataInfo(nevt_, (unsigned int)hit->GetPmtID(),
-                                     time_bin, charge);
+      block.sensor_samples.push_back({sensor_id, time_bin, charge});
     }
 
-    std::vector<G4int>::iterator pos_it =
-      std::find(sns_posvec_.begin(), sns_posvec_.end(), hit->GetPmtID());
-    if (pos_it == sns_posvec_.end()) {
-      h5writer_->WriteSensorPosInfo((unsigned int)hit->GetPmtID(), sdname.c_str(),
-				    (float)xyz.x(), (float)xyz.y(), (float)xyz.z());
-      sns_posvec_.push_back(hit->GetPmtID());
+    if (known_sensors_.insert(hit->GetPmtID()).second) {
+      block.sensor_positions.push_back({sensor_id, sdname,
+                                        (float)xyz.x(), (float)xyz.y(),
+                                        (float)xyz.z()});
     }
 
   }
 }
 
 
-void PersistencyManager::StoreSteps()
+void PersistencyManager::StoreSteps(EventOutputBlock& block)
 {
   SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
     G4RunManager::GetRunManager()->GetUserSteppingAction();
@@ -359,30 +427,274 @@ void PersistencyManager::StoreSteps()
     G4String                   particle_name = key.second;
 
     for (size_t step_id=0; step_id < it->second.size(); ++step_id) {
-      h5writer_->WriteStep(nevt_, track_id, particle_name, step_id,
-                           initial_volumes[key][step_id],
-                             final_volumes[key][step_id],
-                                proc_names[key][step_id],
-                           initial_poss   [key][step_id].x(),
-                           initial_poss   [key][step_id].y(),
-                           initial_poss   [key][step_id].z(),
-                             final_poss   [key][step_id].x(),
-                             final_poss   [key][step_id].y(),
-                             final_poss   [key][step_id].z());
+      EventOutputBlock::Step s;
+      s.particle_id    = track_id;
+      s.particle_name  = particle_name;
+      s.step_id        = step_id;
+      s.initial_volume = initial_volumes[key][step_id];
+      s.  final_volume =   final_volumes[key][step_id];
+      s.     proc_name =      proc_names[key][step_id];
+      s.initial_x      = initial_poss   [key][step_id].x();
+      s.initial_y      = initial_poss   [key][step_id].y();
+      s.initial_z      = initial_poss   [key][step_id].z();
+      s.  final_x      =   final_poss   [key][step_id].x();
+      s.  final_y      =   final_poss   [key][step_id].y();
+      s.  final_z      =   final_poss   [key][step_id].z();
+      block.steps.push_back(std::move(s));
     }
   }
   sa->Reset();
 }
 
-G4bool PersistencyManager::Store(const G4Run*)
+
+void PersistencyManager::Push(EventOutputBlock* block)
 {
+  // The writer thread is started by the first block of the run
+  if (!writer_running_.load(std::memory_order_acquire)) {
+    G4AutoLock lock(&writerMutex);
+    if (!writer_running_.load(std::memory_order_relaxed)) StartWriter();
+  }
+
+  if (queue_->TryPush(block)) return;
+
+  // The queue is full: wait for the writer to make room,
+  // keeping track of the time lost by this producer
+  auto start = std::chrono::steady_clock::now();
+  while (!queue_->TryPush(block)) std::this_thread::yield();
+  auto stall = std::chrono::steady_clock::now() - start;
+  stall_ns_ +=
+    std::chrono::duration_cast<std::chrono::nanoseconds>(stall).count();
+}
+
+
+
+void PersistencyManager::StartWriter()
+{
+  if (!queue_ || queue_->Capacity() < (size_t)queue_size_) {
+    delete queue_;
+    queue_ = new BoundedQueue<EventOutputBlock*>(queue_size_);
+  }
+
+  next_evt_id_ = 0;
+  stall_ns_    = 0;
+  max_depth_   = 0;
+  sum_depth_   = 0.;
+  nblocks_     = 0;
+
+  writer_ = std::thread(&PersistencyManager::WriteLoop, this);
+  writer_running_.store(true, std::memory_order_release);
+}
+
+
+
+void PersistencyManager::StopWriter()
+{
+  if (!writer_running_) return;
+
+  // A null block tells the writer that no more events will come
+  while (!queue_->TryPush(nullptr)) std::this_thread::yield();
+  writer_.join();
+  writer_running_ = false;
+}
+
+
+
+void PersistencyManager::WriteLoop()
+{
+  G4int nidle = 0;
+
+  while (true) {
+
+    size_t depth = queue_->Size();
+
+    EventOutputBlock* block;
+    if (!queue_->TryPop(block)) {
+      // Back off gently while the producers are busy simulating
+      if (++nidle < 64) std::this_thread::yield();
+      else std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+    nidle = 0;
+
+    if (!block) break;
+
+    max_depth_ = std::max(max_depth_, depth);
+    sum_depth_ += depth;
+    nblocks_++;
+
+    if (!strict_order_) {
+      WriteBlock(block);
+      continue;
+    }
+
+    pending_[block->event_id] = block;
+    while (!pending_.empty() && pending_.begin()->first == next_evt_id_) {
+      WriteBlock(pending_.begin()->second);
+      pending_.erase(pending_.begin());
+      next_evt_id_++;
+    }
+  }
+
+  // Events that never arrived (e.g. after the run was aborted)
+  // leave gaps; write whatever is left in order of event ID
+  for (auto& p: pending_) WriteBlock(p.second);
+  pending_.clear();
+}
+
+
+
+void PersistencyManager::WriteBlock(EventOutputBlock* block)
+{
+  if (block->interacting) {
+    interacting_evts_++;
+  }
+
+  if (!block->store) {
+    delete block;
+    return;
+  }
+
+  saved_evts_++;
+
+  if (first_evt_) {
+    first_evt_ = false;
+    nevt_ = start_id_;
+  }
+
+  for (auto& b: block->binnings)
+    sensdet_bin_.insert(b);
+
+  if (h5writer_->UsesCodes()) {
+
+    for (auto& s: block->steps) {
+      h5writer_->WriteStepCodes(nevt_, s.particle_id,
+                                GetStringCode(HDF5Writer::PARTICLE_NAMES, s.particle_name),
+                                s.step_id,
+                                GetStringCode(HDF5Writer::VOLUME_NAMES, s.initial_volume),
+                                GetStringCode(HDF5Writer::VOLUME_NAMES, s.final_volume),
+                                GetStringCode(HDF5Writer::PROCESS_NAMES, s.proc_name),
+                                s.initial_x, s.initial_y, s.initial_z,
+                                s.final_x, s.final_y, s.final_z);
+    }
+
+    for (auto& p: block->particles) {
+      h5writer_->WriteParticleCodes(nevt_, p.particle_id,
+                                    GetStringCode(HDF5Writer::PARTICLE_NAMES, p.name),
+                                    p.primary, p.mother_id,
+                                    p.initial_x, p.initial_y,
+                                    p.initial_z, p.initial_t,
+                                    p.final_x, p.final_y,
+                                    p.final_z, p.final_t,
+                                    GetStringCode(HDF5Writer::VOLUME_NAMES, p.initial_volume),
+                                    GetStringCode(HDF5Writer::VOLUME_NAMES, p.final_volume),
+                                    p.initial_momentum_x, p.initial_momentum_y,
+                                    p.initial_momentum_z, p.final_momentum_x,
+                                    p.final_momentum_y, p.final_momentum_z,
+                                    p.kin_energy, p.length,
+                                    GetStringCode(HDF5Writer::PROCESS_NAMES, p.creator_proc),
+                                    GetStringCode(HDF5Writer::PROCESS_NAMES, p.final_proc));
+    }
+
+    for (auto& h: block->hits) {
+      h5writer_->WriteHitCodes(nevt_, h.particle_id, h.hit_id,
+                               h.x, h.y, h.z, h.time, h.energy,
+                               GetStringCode(HDF5Writer::HIT_LABELS, h.label));
+    }
+
+  } else {
+    for (auto& s: block->steps) {
+      h5writer_->WriteStep(nevt_, s.particle_id, s.particle_name.c_str(),
+                           s.step_id, s.initial_volume.c_str(),
+                           s.final_volume.c_str(), s.proc_name.c_str(),
+                           s.initial_x, s.initial_y, s.initial_z,
+                           s.final_x, s.final_y, s.final_z);
+    }
+
+    for (auto& p: block->particles) {
+      h5writer_->WriteParticleInfo(nevt_, p.particle_id, p.name.c_str(),
+                                   p.primary, p.mother_id,
+                                   p.initial_x, p.initial_y,
+                                   p.initial_z, p.initial_t,
+                                   p.final_x, p.final_y,
+                                   p.final_z, p.final_t,
+                                   p.initial_volume.c_str(),
+                                   p.final_volume.c_str(),
+                                   p.initial_momentum_x, p.initial_momentum_y,
+                                   p.initial_momentum_z, p.final_momentum_x,
+                                   p.final_momentum_y, p.final_momentum_z,
+                                   p.kin_energy, p.length,
+                                   p.creator_proc.c_str(),
+                                   p.final_proc.c_str());
+    }
+
+    for (auto& h: block->hits) {
+      h5writer_->WriteHitInfo(nevt_, h.particle_id, h.hit_id,
+                              h.x, h.y, h.z, h.time, h.energy,
+                              h.label.c_str());
+    }
+
+  }
+
+  for (auto& s: block->sensor_samples) {
+    h5writer_->WriteSensorDataInfo(nevt_, s.sensor_id, s.time_bin, s.charge);
+  }
+
+  for (auto& s: block->sensor_positions) {
+    std::vector<G4int>::iterator pos_it =
+      std::find(sns_posvec_.begin(), sns_posvec_.end(), (G4int)s.sensor_id);
+    if (pos_it == sns_posvec_.end()) {
+      h5writer_->WriteSensorPosInfo(s.sensor_id, s.name.c_str(),
+                                    s.x, s.y, s.z);
+      sns_posvec_.push_back(s.sensor_id);
+    }
+  }
+
+  h5writer_->WriteEventIndex(nevt_);
+
+  nevt_++;
+
+  delete block;
+}
+
+G4int PersistencyManager::GetStringCode(G4int table, const std::string& name)
+{
+  std::unordered_map<std::string, G4int>& codes = string_codes_[table];
+
+  auto it = codes.find(name);
+  if (it != codes.end()) return it->second;
+
+  G4int code = codes.size();
+  codes.emplace(name, code);
+  h5writer_->WriteStringCode((HDF5Writer::StringTable)table, code, name.c_str());
+  return code;
+}
+
+
+
+G4bool PersistencyManager::Store(const G4Run* run)
+{
+  // The run summary is written once, by the master thread
+  if (this != master_) return false;
+
+  // Wait for the writer thread to finish with the events of the run
+  StopWriter();
+
+  if (nblocks_ > 0) {
+    G4cout << "[PersistencyManager] Output queue: capacity "
+           << queue_->Capacity() << ", max depth " << max_depth_
+           << ", mean depth " << sum_depth_/nblocks_
+           << ", producer stall time " << stall_ns_*1.e-9 << " s" << G4endl;
+  }
+
+  // Write to file the rows still buffered for the last events of the run
+  h5writer_->Flush();
+
   // Store the event type
   G4String key = "event_type";
   h5writer_->WriteRunInfo(key, event_type_.c_str());
 
   // Store the number of events to be processed
-  NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
-  G4int num_events = app->GetNumberOfEventsToBeProcessed();
+  G4int num_events = run->GetNumberOfEventToBeProcessed();
 
   key = "num_events";
   h5writer_->WriteRunInfo(key,  std::to_string(num_events).c_str());
@@ -2,7 +2,10 @@
 // nexus | PersistencyManager.h
 //
 // This class writes all the relevant information of the simulation
-// to an ouput file.
+// to an ouput file. Every thread has its own instance, which packs the
+// output of each event in a block and hands it over to the master
+// instance through a bounded queue. A dedicated writer thread owned by
+// the master instance is the only one touching the output file.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -11,10 +14,15 @@
 #define PERSISTENCY_MANAGER_H
 
 #include "PersistencyManagerBase.h"
+#include "BoundedQueue.h"
 
 #include <G4VPersistencyManager.hh>
 #include <map>
+#include <set>
 #include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
 
 
 class G4GenericMessenger;
@@ -25,6 +33,7 @@ class G4VHitsCollection;
 namespace nexus {
   class HDF5Writer;
   class IonizationHit;
+  struct EventOutputBlock;
 }
 
 namespace nexus {
@@ -61,11 +70,23 @@ namespace nexus {
 
 
   private:
-    void StoreTrajectories(G4TrajectoryContainer*);
-    void StoreHits(G4HCofThisEvent*);
-    void StoreIonizationHits(G4VHitsCollection*);
-    void StoreSensorHits(G4VHitsCollection*);
-    void StoreSteps();
+    void StoreTrajectories(G4TrajectoryContainer*, EventOutputBlock&);
+    void StoreHits(G4HCofThisEvent*, EventOutputBlock&);
+    void StoreIonizationHits(G4VHitsCollection*, EventOutputBlock&);
+    void StoreSensorHits(G4VHitsCollection*, EventOutputBlock&);
+    void StoreSteps(EventOutputBlock&);
+
+    /// Hand over an event block to the writer thread,
+    /// waiting while the queue is full
+    void Push(EventOutputBlock*);
+    void StartWriter();
+    void StopWriter();
+    /// Main loop of the writer thread
+    void WriteLoop();
+    void WriteBlock(EventOutputBlock*);
+    /// Returns the code of a string in the given table of the writer,
+    /// defining a new one the first time the string is seen
+    G4int GetStringCode(G4int table, const std::string&);
 
     void SaveConfigurationInfo(G4String history);
 
@@ -96,10 +117,41 @@ namespace nexus {
 
     HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
 
-    std::map<G4int, std::vector<G4int>* > hit_map_;
-    std::vector<G4int> sns_posvec_;
+    /// Instance of the master thread, which owns the output file
+    static PersistencyManager* master_;
+
+    // State of the producing thread
+    std::set<G4int> known_sensors_; ///< sensors already sent to the writer
+    std::set<G4String> known_sensdets_; ///< binnings already sent to the writer
+
+    // State of the writer thread
+    BoundedQueue<EventOutputBlock*>* queue_; ///< event blocks waiting to be written
+    std::thread writer_;
+    std::atomic<G4bool> writer_running_;
+    G4int queue_size_; ///< capacity of the queue of event blocks
+    G4bool strict_order_; ///< write events in order of Geant4 event ID?
+    G4int next_evt_id_; ///< next event ID to be written in strict order
+    std::map<G4int, EventOutputBlock*> pending_; ///< blocks arrived out of order
 
+    std::vector<G4int> sns_posvec_;
     std::map<G4String, G4double> sensdet_bin_;
+
+    G4bool use_codes_; ///< write names as integer codes?
+
+    // Storage layout of the hits, particles, sns_response and steps tables
+    static const G4int num_tables_ = 4;
+    G4int chunk_size_[num_tables_]; ///< rows per chunk (0: adapted to the row size)
+    G4bool shuffle_[num_tables_];
+    G4String compression_[num_tables_]; ///< none or gzip
+    G4int compression_level_[num_tables_];
+    /// Code of every string written so far, one map per table of codes
+    std::vector<std::unordered_map<std::string, G4int>> string_codes_;
+
+    // Queue statistics for the current run
+    std::atomic<int64_t> stall_ns_; ///< time producers waited on a full queue
+    size_t max_depth_;
+    double sum_depth_;
+    int64_t nblocks_;
   };
 
 
@@ -134,7 +134,120 @@ hsize_t createStepType()
   return memtype;
 }
 
-hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
+hsize_t createHitCodeType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (hit_code_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (hit_code_t, event_id), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "x", HOFFSET (hit_code_t, x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "y", HOFFSET (hit_code_t, y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "z", HOFFSET (hit_code_t, z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "time", HOFFSET (hit_code_t, time), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "energy", HOFFSET (hit_code_t, energy), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "label", HOFFSET (hit_code_t, label), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "particle_id", HOFFSET (hit_code_t, particle_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "hit_id", HOFFSET (hit_code_t, hit_id), H5T_NATIVE_INT);
+  return memtype;
+}
+
+
+hsize_t createParticleCodeType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (particle_code_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (particle_code_t, event_id), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "particle_id", HOFFSET (particle_code_t, particle_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "particle_name", HOFFSET (particle_code_t, particle_name), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "primary", HOFFSET (particle_code_t, primary), H5T_NATIVE_CHAR);
+  H5Tinsert (memtype, "mother_id", HOFFSET (particle_code_t, mother_id),H5T_NATIVE_INT);
+  H5Tinsert (memtype, "initial_x", HOFFSET (particle_code_t, initial_x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_y", HOFFSET (particle_code_t, initial_y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_z", HOFFSET (particle_code_t, initial_z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_t", HOFFSET (particle_code_t, initial_t), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_x", HOFFSET (particle_code_t, final_x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_y", HOFFSET (particle_code_t, final_y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_z", HOFFSET (particle_code_t, final_z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_t", HOFFSET (particle_code_t, final_t), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_volume", HOFFSET (particle_code_t, initial_volume), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "final_volume", HOFFSET (particle_code_t, final_volume), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "initial_momentum_x", HOFFSET (particle_code_t, initial_momentum_x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_momentum_y", HOFFSET (particle_code_t, initial_momentum_y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_momentum_z", HOFFSET (particle_code_t, initial_momentum_z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_momentum_x", HOFFSET (particle_code_t, final_momentum_x), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_momentum_y", HOFFSET (particle_code_t, final_momentum_y), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_momentum_z", HOFFSET (particle_code_t, final_momentum_z), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "kin_energy", HOFFSET (particle_code_t, kin_energy), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "length", HOFFSET (particle_code_t, length), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "creator_proc", HOFFSET (particle_code_t, creator_proc), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "final_proc", HOFFSET (particle_code_t, final_proc), H5T_NATIVE_INT);
+  return memtype;
+}
+
+
+hsize_t createStepCodeType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(step_code_t));
+  H5Tinsert (memtype, "event_id"      , HOFFSET(step_code_t, event_id      ), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "particle_id"   , HOFFSET(step_code_t, particle_id   ), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "particle_name" , HOFFSET(step_code_t, particle_name ), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "step_id"       , HOFFSET(step_code_t, step_id       ), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "initial_volume", HOFFSET(step_code_t, initial_volume), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "final_volume"  , HOFFSET(step_code_t, final_volume  ), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "proc_name"     , HOFFSET(step_code_t, proc_name     ), H5T_NATIVE_INT  );
+  H5Tinsert (memtype, "initial_x"     , HOFFSET(step_code_t, initial_x     ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_y"     , HOFFSET(step_code_t, initial_y     ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "initial_z"     , HOFFSET(step_code_t, initial_z     ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_x"       , HOFFSET(step_code_t, final_x       ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_y"       , HOFFSET(step_code_t, final_y       ), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "final_z"       , HOFFSET(step_code_t, final_z       ), H5T_NATIVE_FLOAT);
+  return memtype;
+}
+
+
+hsize_t createStringCodeType()
+{
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size (strtype, STRLEN);
+
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (string_code_t));
+  H5Tinsert (memtype, "code", HOFFSET (string_code_t, code), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "name", HOFFSET (string_code_t, name), strtype);
+  return memtype;
+}
+
+hsize_t createEventIndexType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_index_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_index_t, event_id), H5T_NATIVE_INT64);
+  H5Tinsert (memtype, "hits_start", HOFFSET (event_index_t, hits_start), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "hits_count", HOFFSET (event_index_t, hits_count), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "particles_start", HOFFSET (event_index_t, particles_start), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "particles_count", HOFFSET (event_index_t, particles_count), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "sns_response_start", HOFFSET (event_index_t, sns_response_start), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "sns_response_count", HOFFSET (event_index_t, sns_response_count), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "steps_start", HOFFSET (event_index_t, steps_start), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "steps_count", HOFFSET (event_index_t, steps_count), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
+
+hsize_t chunkRows(hsize_t memtype, const table_options_t& options)
+{
+  if (options.chunk_size > 0) return options.chunk_size;
+
+  // Largest power of two that keeps the chunk within CHUNKBYTES,
+  // so that it fits in the default chunk cache of the library
+  hsize_t row_size = H5Tget_size(memtype);
+  hsize_t rows = 1024;
+  while (2 * rows * row_size <= CHUNKBYTES) rows *= 2;
+  return rows;
+}
+
+hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype,
+                  const table_options_t& options)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
   const hsize_t ndims = 1;
@@ -146,17 +259,22 @@ hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
   // The layout of the dataset have to be chunked when using unlimited dimensions
   hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
   H5Pset_layout(plist, H5D_CHUNKED);
-  hsize_t chunk_dims[ndims] = {32768};
+  hsize_t chunk_dims[ndims] = {chunkRows(memtype, options)};
   H5Pset_chunk(plist, ndims, chunk_dims);
 
   //Set compression
-  //  int clevel = 0;
-  //  H5Pset_deflate (plist, clevel);
+  if (options.filter == "gzip" && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+    if (options.shuffle) H5Pset_shuffle(plist);
+    H5Pset_deflate(plist, options.level);
+  }
 
   // Create dataset
   hid_t dataset = H5Dcreate(group, table_name.c_str(), memtype, file_space,
                             H5P_DEFAULT, plist, H5P_DEFAULT);
 
+  H5Pclose(plist);
+  H5Sclose(file_space);
+
   return dataset;
 }
 
@@ -169,56 +287,36 @@ hid_t createGroup(hid_t file, std::string& groupName)
   return wfgroup;
 }
 
-void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter)
+void writeRows(const void* rows, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows)
 {
-  hid_t memspace, file_space;
-  hsize_t dims[1] = {1};
-  memspace = H5Screate_simple(1, dims, NULL);
-
-  //Extend dataset
-  dims[0] = counter+1;
-  H5Dset_extent(dataset, dims);
-
-  file_space = H5Dget_space(dataset);
-  hsize_t start[1] = {counter};
-  hsize_t count[1] = {1};
-  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, runData);
-  H5Sclose(file_space);
-  H5Sclose(memspace);
-}
-
+  if (nrows == 0) return;
 
-void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter)
-{
   hid_t memspace, file_space;
-  //Create memspace for one more row
+  //Create memspace for the block of rows
   const hsize_t n_dims = 1;
-  hsize_t dims[n_dims] = {1};
+  hsize_t dims[n_dims] = {nrows};
   memspace = H5Screate_simple(n_dims, dims, NULL);
 
   //Extend dataset
-  dims[0] = counter+1;
+  dims[0] = counter + nrows;
   H5Dset_extent(dataset, dims);
 
-  //Write waveforms
   file_space = H5Dget_space(dataset);
   hsize_t start[1] = {counter};
-  hsize_t count[1] = {1};
+  hsize_t count[1] = {nrows};
   H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, snsData);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, rows);
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
 
-void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter)
+void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter)
 {
   hid_t memspace, file_space;
+  hsize_t dims[1] = {1};
+  memspace = H5Screate_simple(1, dims, NULL);
 
-  const hsize_t n_dims = 1;
-  hsize_t dims[n_dims] = {1};
-  memspace = H5Screate_simple(n_dims, dims, NULL);
-
+  //Extend dataset
   dims[0] = counter+1;
   H5Dset_extent(dataset, dims);
 
@@ -226,29 +324,25 @@ void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter
   hsize_t start[1] = {counter};
   hsize_t count[1] = {1};
   H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, hitInfo);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, runData);
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
 
-void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter)
-{
-  hid_t memspace, file_space;
 
-  const hsize_t n_dims = 1;
-  hsize_t dims[n_dims] = {1};
-  memspace = H5Screate_simple(n_dims, dims, NULL);
+void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows)
+{
+  writeRows(snsData, dataset, memtype, counter, nrows);
+}
 
-  dims[0] = counter+1;
-  H5Dset_extent(dataset, dims);
+void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows)
+{
+  writeRows(hitInfo, dataset, memtype, counter, nrows);
+}
 
-  file_space = H5Dget_space(dataset);
-  hsize_t start[1] = {counter};
-  hsize_t count[1] = {1};
-  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, particleInfo);
-  H5Sclose(file_space);
-  H5Sclose(memspace);
+void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows)
+{
+  writeRows(particleInfo, dataset, memtype, counter, nrows);
 }
 
 void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter)
@@ -273,22 +367,17 @@ void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counte
   H5Sclose(memspace);
 }
 
-void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter)
+void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows)
 {
-  hid_t memspace, file_space;
-
-  const hsize_t n_dims = 1;
-  hsize_t dims[n_dims] = {1};
-  memspace = H5Screate_simple(n_dims, dims, NULL);
-
-  dims[0] = counter + 1;
-  H5Dset_extent(dataset, dims);
+  writeRows(step, dataset, memtype, counter, nrows);
+}
 
-  file_space = H5Dget_space(dataset);
-  hsize_t start[1] = {counter};
-  hsize_t count[1] = {1};
-  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
-  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, step);
+void getTableSize(hid_t dataset, hsize_t& raw_bytes, hsize_t& stored_bytes)
+{
+  hid_t file_space = H5Dget_space(dataset);
+  hid_t type = H5Dget_type(dataset);
+  raw_bytes = H5Sget_simple_extent_npoints(file_space) * H5Tget_size(type);
+  stored_bytes = H5Dget_storage_size(dataset);
+  H5Tclose(type);
   H5Sclose(file_space);
-  H5Sclose(memspace);
 }
@@ -11,9 +11,20 @@
 
 #include <hdf5.h>
 #include <iostream>
+#include <string>
 
 #define CONFLEN 300
 #define STRLEN 100
+#define CHUNKSIZE 32768
+#define CHUNKBYTES 1048576
+
+  /// Storage layout of a table
+  struct table_options_t {
+    hsize_t chunk_size = 0;      ///< rows per chunk (0: about CHUNKBYTES per chunk)
+    bool shuffle = true;         ///< shuffle the bytes of the rows before compressing
+    std::string filter = "gzip"; ///< compression filter: none or gzip
+    int level = 4;               ///< compression level
+  };
 
   typedef struct{
      char param_key[CONFLEN];
@@ -91,22 +102,114 @@
     float     final_z;
   } step_info_t;
 
+  // Rows of the hits, particles and steps tables when strings are
+  // replaced by integer codes, defined in the string code tables
+  typedef struct{
+        int64_t event_id;
+	float x;
+	float y;
+	float z;
+	float time;
+	float energy;
+        int label;
+        int particle_id;
+        int hit_id;
+  } hit_code_t;
+
+  typedef struct{
+        int64_t event_id;
+	int particle_id;
+	int particle_name;
+        char primary;
+	int mother_id;
+	float initial_x;
+	float initial_y;
+	float initial_z;
+	float initial_t;
+	float final_x;
+	float final_y;
+	float final_z;
+	float final_t;
+        int initial_volume;
+        int final_volume;
+	float initial_momentum_x;
+	float initial_momentum_y;
+	float initial_momentum_z;
+	float final_momentum_x;
+	float final_momentum_y;
+	float final_momentum_z;
+	float kin_energy;
+	float length;
+        int creator_proc;
+	int final_proc;
+  } particle_code_t;
+
+  typedef struct{
+    int64_t event_id;
+    int32_t particle_id;
+    int     particle_name;
+    int     step_id;
+    int     initial_volume;
+    int       final_volume;
+    int          proc_name;
+    float   initial_x;
+    float   initial_y;
+    float   initial_z;
+    float     final_x;
+    float     final_y;
+    float     final_z;
+  } step_code_t;
+
+  typedef struct{
+    int code;
+    char name[STRLEN];
+  } string_code_t;
+
+  // First row and number of rows of one event in each table
+  typedef struct{
+    int64_t event_id;
+    uint64_t hits_start;
+    uint64_t hits_count;
+    uint64_t particles_start;
+    uint64_t particles_count;
+    uint64_t sns_response_start;
+    uint64_t sns_response_count;
+    uint64_t steps_start;
+    uint64_t steps_count;
+  } event_index_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
   hsize_t createHitInfoType();
   hsize_t createParticleInfoType();
   hsize_t createSensorPosType();
   hsize_t createStepType();
+  hsize_t createHitCodeType();
+  hsize_t createParticleCodeType();
+  hsize_t createStepCodeType();
+  hsize_t createStringCodeType();
+  hsize_t createEventIndexType();
 
-  hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
+  /// Number of rows per chunk of a table with the given row type
+  hsize_t chunkRows(hsize_t memtype, const table_options_t& options);
+
+  hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype,
+                    const table_options_t& options=table_options_t());
   hid_t createGroup(hid_t file, std::string& groupName);
 
   void writeRun(run_info_t* runData, hid_t dataset, hid_t memtype, hsize_t counter);
-  void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter);
-  void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter);
-  void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSnsData(sns_data_t* snsData, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows=1);
+  void writeHit(hit_info_t* hitInfo, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows=1);
+  void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows=1);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
-  void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows=1);
+
+  /// Size of the rows of a table in memory and on disk
+  void getTableSize(hid_t dataset, hsize_t& raw_bytes, hsize_t& stored_bytes);
+
+  /// Append nrows contiguous rows starting at row counter, extending
+  /// the dataset only once
+  void writeRows(const void* rows, hid_t dataset, hid_t memtype, hsize_t counter, hsize_t nrows);
 
 
 #endif
@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// nexus | DriftLookupTable.cc
+//
+// Drift field of every logical volume and attachment of every material,
+// resolved once so that the drift processes can find them at every step
+// without string lookups or dynamic casts.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "DriftLookupTable.h"
+
+#include "BaseDriftField.h"
+#include "UniformElectricDriftField.h"
+
+#include <G4LogicalVolumeStore.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4Region.hh>
+
+using namespace nexus;
+
+
+
+DriftLookupTable::DriftLookupTable()
+{
+}
+
+
+
+DriftLookupTable::~DriftLookupTable()
+{
+}
+
+
+
+void DriftLookupTable::Build()
+{
+  fields_.clear();
+  attachment_.clear();
+
+  for (const G4LogicalVolume* lv: *G4LogicalVolumeStore::GetInstance()) {
+    size_t id = lv->GetInstanceID();
+    if (id >= fields_.size()) fields_.resize(id+1, Entry{nullptr, nullptr});
+    BaseDriftField* field = FindField(*lv);
+    fields_[id].field = field;
+    fields_[id].uniform_field = dynamic_cast<UniformElectricDriftField*>(field);
+  }
+
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  attachment_.reserve(materials->size());
+  for (const G4Material* mat: *materials)
+    attachment_.push_back(FindAttachment(*mat));
+}
+
+
+
+UniformElectricDriftField*
+DriftLookupTable::GetUniformField(const G4LogicalVolume& lv) const
+{
+  size_t id = lv.GetInstanceID();
+  if (id < fields_.size()) return fields_[id].uniform_field;
+  return dynamic_cast<UniformElectricDriftField*>(FindField(lv));
+}
+
+
+
+UniformElectricDriftField*
+DriftLookupTable::GetFastDriftField(const G4LogicalVolume& lv) const
+{
+  // Charges created in an EL gap must be tracked through it
+  // for their light to be generated
+  UniformElectricDriftField* field = GetUniformField(lv);
+  return (field && field->LightYield() <= 0.) ? field : nullptr;
+}
+
+
+
+BaseDriftField* DriftLookupTable::FindField(const G4LogicalVolume& lv)
+{
+  G4Region* region = lv.GetRegion();
+  if (!region) return nullptr;
+  return dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+}
+
+
+
+G4double DriftLookupTable::FindAttachment(const G4Material& mat)
+{
+  G4MaterialPropertiesTable* mpt = mat.GetMaterialPropertiesTable();
+  if (!mpt || !mpt->ConstPropertyExists("ATTACHMENT")) return -1.;
+  return mpt->GetConstProperty("ATTACHMENT");
+}
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | DriftLookupTable.h
+//
+// Drift field of every logical volume and attachment of every material,
+// resolved once so that the drift processes can find them at every step
+// without string lookups or dynamic casts.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DRIFT_LOOKUP_TABLE_H
+#define DRIFT_LOOKUP_TABLE_H
+
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class BaseDriftField;
+  class UniformElectricDriftField;
+
+  class DriftLookupTable
+  {
+  public:
+    /// Constructor
+    DriftLookupTable();
+    /// Destructor
+    ~DriftLookupTable();
+
+    /// Resolve the fields of all the logical volumes and the attachment
+    /// of all the materials defined so far. Volumes and materials
+    /// created afterwards are looked up on every call.
+    void Build();
+
+    /// Drift field of the region of the volume, or null if none
+    BaseDriftField* GetField(const G4LogicalVolume&) const;
+    /// Drift field of the region of the volume if it is uniform,
+    /// or null otherwise
+    UniformElectricDriftField* GetUniformField(const G4LogicalVolume&) const;
+    /// Drift field of the region of the volume if it is uniform and
+    /// has no light yield (i.e. not an EL gap), so that charges can be
+    /// drifted to its anode at once, or null otherwise
+    UniformElectricDriftField* GetFastDriftField(const G4LogicalVolume&) const;
+
+    /// Electron lifetime due to attachment (ATTACHMENT constant
+    /// property) in the material, or a negative value if not defined
+    G4double GetAttachment(const G4Material&) const;
+
+  private:
+    static BaseDriftField* FindField(const G4LogicalVolume&);
+    static G4double FindAttachment(const G4Material&);
+
+  private:
+    struct Entry {
+      BaseDriftField* field;
+      UniformElectricDriftField* uniform_field;
+    };
+
+    std::vector<Entry> fields_;         ///< Indexed by logical volume ID
+    std::vector<G4double> attachment_;  ///< Indexed by material index
+  };
+
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline BaseDriftField*
+  DriftLookupTable::GetField(const G4LogicalVolume& lv) const
+  {
+    size_t id = lv.GetInstanceID();
+    return (id < fields_.size()) ? fields_[id].field : FindField(lv);
+  }
+
+  inline G4double DriftLookupTable::GetAttachment(const G4Material& mat) const
+  {
+    size_t idx = mat.GetIndex();
+    return (idx < attachment_.size()) ? attachment_[idx] : FindAttachment(mat);
+  }
+
+} // end namespace nexus
+
+#endif
@@ -8,23 +8,84 @@
 
 #include "ELLookupTable.h"
 
+#include <G4SystemOfUnits.hh>
+
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <set>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace {
+
+  /// Header of the binary format of the EL tables. It is followed by
+  /// the list of sensor IDs (int32), the per-point offsets (uint64),
+  /// the sensor ID of every entry (int32) and the probabilities of
+  /// every entry (num_tbins float32 each). Every section starts at
+  /// a multiple of 8 bytes. Numbers use the native byte order.
+  struct ELTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_tbins;
+    double radius;       // in mm
+    double pitch;        // in mm
+    uint64_t num_points;
+    uint64_t num_entries;
+    uint64_t num_sensors;
+    uint64_t reserved;
+  };
+
+  const char ELTABLE_MAGIC[8] = {'N','X','E','L','T','A','B','L'};
+  const uint32_t ELTABLE_VERSION = 1;
+
+  static_assert(sizeof(G4int) == sizeof(int32_t) && sizeof(G4float) == 4,
+                "EL tables in binary format are mapped as 32-bit values");
+
+  size_t Align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+}
 
 
 
 namespace nexus {
 
 
-  ELLookupTable::ELLookupTable(G4String filename)
+  ELLookupTable::ELLookupTable(G4String filename):
+    radius_(92.5*mm), pitch_(5.*mm), num_tbins_(5),
+    nbins_(0), grid_min_(0.), num_points_(0),
+    offsets_(0), sensor_ids_(0), probs_(0), num_entries_(0),
+    map_addr_(0), map_size_(0)
   {
-    // read the text files and store their content in the transient table
-    ReadFiles(filename);
+    if (IsBinaryFile(filename))
+      MapBinaryFile(filename);
+    else
+      // read the text files and store their content in the transient table
+      ReadFiles(filename);
   }
 
 
 
   ELLookupTable::~ELLookupTable()
   {
+    if (map_addr_) munmap(map_addr_, map_size_);
+  }
+
+
+
+  G4bool ELLookupTable::IsBinaryFile(G4String filename)
+  {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, ELTABLE_MAGIC, sizeof(magic)) == 0;
   }
 
 
@@ -32,178 +93,279 @@ namespace nexus {
   void ELLookupTable::ReadFiles(G4String filename)
   {
     // Open the file containing the light table
-    std::ifstream file(filename, std::ifstream::out);
+    std::ifstream file(filename);
 
-    if (!file.is_open())
-      {}
-      //G4Exception("[ELLookupTable] ERROR: cannot open input file!");
+    if (!file.is_open()) {
+      G4String msg = "Cannot open EL table file " + filename;
+      G4Exception("[ELLookupTable]", "ReadFiles()", FatalException, msg);
+    }
 
-    // Deal with the header file
+    // Header lines start with '*'. Those of the form "* key value" set
+    // the grid geometry; otherwise, the default one is used.
     G4String line;
-
-    do {
+    while (file.peek() == '*') {
       getline(file, line);
-    } while(line[0] == '*');
-
-    // Read file and store content in the transient table
+      std::istringstream header(line.substr(1));
+      G4String key;
+      G4double value;
+      if (!(header >> key >> value)) continue;
+
+      if      (key == "radius")    radius_ = value * mm;
+      else if (key == "pitch")     pitch_ = value * mm;
+      else if (key == "time_bins") num_tbins_ = (G4int) value;
+    }
 
-    int num_bins = 5;
-    int last_point_id = 0;
-    std::map<int, std::vector<double> > sensor_map;
+    BuildIndex();
 
-    while (!file.eof()) {
+    // Read file and store content in the transient table. Entries
+    // are expected to be sorted by EL point ID.
+    offsets_buf_.assign(1, 0);
+    sensor_ids_buf_.clear();
+    probs_buf_.clear();
 
-      G4int point_id, sensor_id;
-      std::vector<double> probs;
+    G4int current_point = 0;
+    G4int point_id, sensor_id;
 
-      file >> point_id >> sensor_id;
+    while (file >> point_id >> sensor_id) {
 
-      for (G4int i=0; i<num_bins; i++) {
-	G4double prob;
-	file >> prob;
-	probs.push_back(prob);
+      if (point_id < current_point || point_id >= num_points_) {
+        G4String msg = "Unexpected EL point ID " + std::to_string(point_id)
+          + " in EL table file " + filename;
+        G4Exception("[ELLookupTable]", "ReadFiles()", FatalException, msg);
       }
 
-      sensor_map.insert(std::make_pair(sensor_id, probs));
+      // Close the list of sensors of the points before this one
+      for (; current_point < point_id; ++current_point)
+        offsets_buf_.push_back(sensor_ids_buf_.size());
 
-      if (point_id != last_point_id) {
-	ELtable_.push_back(sensor_map);
+      sensor_ids_buf_.push_back(sensor_id);
+      for (G4int i=0; i<num_tbins_; i++) {
+        G4double prob;
+        file >> prob;
+        probs_buf_.push_back(prob);
       }
-
-      last_point_id = point_id;
     }
+
+    for (; current_point < num_points_; ++current_point)
+      offsets_buf_.push_back(sensor_ids_buf_.size());
+
+    offsets_     = offsets_buf_.data();
+    sensor_ids_  = sensor_ids_buf_.data();
+    probs_       = probs_buf_.data();
+    num_entries_ = sensor_ids_buf_.size();
   }
 
 
 
-  const std::map<int, std::vector<double> >&
-  ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos)
+  void ELLookupTable::MapBinaryFile(G4String filename)
   {
-    /// The EL points must be in the middle of the bins.
-    double radius = 92.5; // mm
-    double binning = 5.; // mm
-    int maxidx = radius*2./binning + 1;
-    /// If the number of bins per axis is odd, a different math must be applied
-    bool even = false;
-    if ((maxidx/2.-floor(maxidx/2.)) == 0.){
-      even = true;
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      G4String msg = "Cannot open EL table file " + filename;
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException, msg);
     }
-    std::vector<double> bincenters;
-    std::vector<int> content;
-    /// Fill a vector with the coordinates of the center of bins (they are the same in
-    /// x and y, because it is a regular squared grid)
-    for (int i=0; i<maxidx; i++){
-      double bincenter = -binning*(maxidx/2.) + binning/2.+ i*binning;
-      bincenters.push_back(bincenter);
+
+    map_size_ = st.st_size;
+    map_addr_ = mmap(0, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map_addr_ == MAP_FAILED) {
+      map_addr_ = 0;
+      G4String msg = "Cannot map EL table file " + filename + " into memory";
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException, msg);
     }
-    /// For every coordinate in x, a column is built with a number of bins equal
-    /// to the number of EL points which have that x. Remember that only the points
-    /// which falls inside a circle of a fixed radius are taken into account,
-    /// so columns have not all the same number of points
-
-    /// Content of elements for every column in the grid
-    std::vector<int> columns;
-    if (even){
-      for (int i=0; i<maxidx; i++){
-	double y = sqrt(radius*radius - bincenters[i]*bincenters[i]);
-	double col = 0;
-	///If the y coord of the circle falls further than the center of the bin,
-	///that bin is included, otherwise it isn't.
-	if ((y/binning) - floor(y/binning)<0.5){
-	  col = floor(y/binning)*2.;
-	} else {
-	  col = ceil(y/binning)*2.;
-	}
-	columns.push_back(col);
-      }
-    } else {
-      columns.push_back(0);
-      for (int i=1; i<maxidx-1; i++){
-	double y = sqrt(radius*radius - bincenters[i]*bincenters[i]);
-	double col = 0;
-	///If the y coord of the circle falls further than the center of the bin,
-	///that bin is included, otherwise it isn't.
-	if ((y-binning/2.)/binning - floor((y-binning/2.)/binning)<0.5){
-	  col = floor((y-binning/2.)/binning)*2.+1;
-	} else {
-	  if (y < radius){
-	    col = ceil((y-binning/2.)/binning)*2.+1;
-	  } else {
-	    col = ceil((y-binning/2.)/binning)*2.-1;
-	  }
-	}
-	columns.push_back(col);
-      }
-      columns.push_back(0);
+
+    const char* base = static_cast<const char*>(map_addr_);
+    const ELTableHeader* header = reinterpret_cast<const ELTableHeader*>(base);
+
+    if (map_size_ < sizeof(ELTableHeader) ||
+        header->version != ELTABLE_VERSION) {
+      G4String msg = "Unsupported version of EL table file " + filename;
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException, msg);
     }
 
-    for (unsigned int i=0; i<columns.size(); i++){
-      content.push_back(columns[i]);
+    radius_      = header->radius * mm;
+    pitch_       = header->pitch * mm;
+    num_tbins_   = header->num_tbins;
+    num_entries_ = header->num_entries;
+
+    BuildIndex();
+
+    size_t pos = sizeof(ELTableHeader);
+    pos += Align8(header->num_sensors * sizeof(int32_t));
+    offsets_ = reinterpret_cast<const uint64_t*>(base + pos);
+    pos += (header->num_points + 1) * sizeof(uint64_t);
+    sensor_ids_ = reinterpret_cast<const G4int*>(base + pos);
+    pos += Align8(num_entries_ * sizeof(int32_t));
+    probs_ = reinterpret_cast<const G4float*>(base + pos);
+    pos += num_entries_ * num_tbins_ * sizeof(float);
+
+    if ((G4int) header->num_points != num_points_ || pos > map_size_) {
+      G4String msg = "EL table file " + filename
+        + " is inconsistent with the grid geometry in its header";
+      G4Exception("[ELLookupTable]", "MapBinaryFile()", FatalException, msg);
     }
+  }
 
-    int id;
 
-    /// Maths to obtain the right ID number of the points
-    int zero = maxidx/2;
-    int binX = zero + ceil(hitpos[0]/5.);
-    int binY = zero + ceil(hitpos[1]/5.);
-    if (!even) {
-      zero = floor(maxidx/2)+1;
-      if (hitpos[0]/binning-floor(hitpos[0]/binning) >= 0.5){
-	binX = zero + ceil(hitpos[0]/binning);
-      } else {
-	binX = zero + floor(hitpos[0]/binning);
-      }
-      if (hitpos[1]/binning-floor(hitpos[1]/binning) >= 0.5){
-	binY = zero + ceil(hitpos[1]/binning);
+
+  void ELLookupTable::WriteBinaryFile(G4String filename) const
+  {
+    std::set<G4int> sensors(sensor_ids_, sensor_ids_ + num_entries_);
+
+    ELTableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ELTABLE_MAGIC, sizeof(header.magic));
+    header.version     = ELTABLE_VERSION;
+    header.num_tbins   = num_tbins_;
+    header.radius      = radius_/mm;
+    header.pitch       = pitch_/mm;
+    header.num_points  = num_points_;
+    header.num_entries = num_entries_;
+    header.num_sensors = sensors.size();
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+      G4String msg = "Cannot open EL table file " + filename;
+      G4Exception("[ELLookupTable]", "WriteBinaryFile()", FatalException, msg);
+    }
+
+    const char padding[8] = {0};
+    auto pad = [&](size_t n) { file.write(padding, Align8(n) - n); };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<int32_t> sensor_list(sensors.begin(), sensors.end());
+    file.write(reinterpret_cast<const char*>(sensor_list.data()),
+               sensor_list.size() * sizeof(int32_t));
+    pad(sensor_list.size() * sizeof(int32_t));
+
+    file.write(reinterpret_cast<const char*>(offsets_),
+               (num_points_ + 1) * sizeof(uint64_t));
+
+    file.write(reinterpret_cast<const char*>(sensor_ids_),
+               num_entries_ * sizeof(int32_t));
+    pad(num_entries_ * sizeof(int32_t));
+
+    file.write(reinterpret_cast<const char*>(probs_),
+               num_entries_ * num_tbins_ * sizeof(float));
+  }
+
+
+
+  void ELLookupTable::BuildIndex()
+  {
+    /// The EL points are in the middle of the bins of a regular
+    /// square grid, and only those inside a circle of a fixed radius
+    /// exist. They are numbered column by column (x) and, within
+    /// a column, in increasing y.
+    nbins_ = radius_*2./pitch_ + 1;
+    grid_min_ = -pitch_ * nbins_/2.;
+
+    /// If the number of bins per axis is odd, a different math must be applied
+    bool even = (nbins_ % 2 == 0);
+
+    std::vector<G4double> bincenters(nbins_);
+    for (G4int i=0; i<nbins_; i++)
+      bincenters[i] = grid_min_ + pitch_/2. + i*pitch_;
+
+    /// Number of EL points in every column of the grid
+    std::vector<G4int> columns(nbins_, 0);
+    for (G4int i=0; i<nbins_; i++) {
+      if (!even && (i == 0 || i == nbins_-1)) continue;
+
+      G4double y =
+        std::sqrt(std::max(0., radius_*radius_ - bincenters[i]*bincenters[i]));
+
+      ///If the y coord of the circle falls further than the center of the bin,
+      ///that bin is included, otherwise it isn't.
+      if (even) {
+        if ((y/pitch_) - std::floor(y/pitch_) < 0.5)
+          columns[i] = std::floor(y/pitch_)*2.;
+        else
+          columns[i] = std::ceil(y/pitch_)*2.;
       } else {
-	binY = zero + floor(hitpos[1]/binning);
+        G4double u = (y - pitch_/2.)/pitch_;
+        if (u - std::floor(u) < 0.5)
+          columns[i] = std::floor(u)*2. + 1;
+        else if (y < radius_)
+          columns[i] = std::ceil(u)*2. + 1;
+        else
+          columns[i] = std::ceil(u)*2. - 1;
       }
     }
-    // "binX-1" is due to the fact that content is a vector (starting from 0),
-    // while binX and binY starts from 1
-
-    // number of empty bins starting from below
-    int base = (maxidx - content[binX-1])/2;
-
-    // Check if the point is in a bin which does not correspond to any
-    // EL point. In this case the closest bin is chosen.
-    if (binY > base + content[binX-1] || binY < base+1){
-      double centerX = bincenters[binX-1];
-      double centerY = bincenters[binY-1];
-      double min_dist = 1.E6;
-      int min_xbin = 100;
-      int min_ybin = 100;
-      for (int i=0; i<maxidx; i++){
-	double x = bincenters[i];
-	for (int j=0; j<maxidx; j++){
-	  double y = bincenters[j];
-	  int bx = zero + ceil(x/5.);
-	  int by = zero + ceil(y/5.);
-	  int ped = (maxidx - content[bx-1])/2;;
-	  if (!(by > ped + content[bx-1] || by < ped+1)){
-	    double dist = sqrt(pow(centerX-x,2)+pow(centerY-y,2));
-	    if (dist < min_dist){
-	      min_dist = dist;
-	      min_xbin = bx;
-	      min_ybin = by;
-	    }
-	  }
-	}
-      }
-      binX = min_xbin;
-      binY = min_ybin;
-      base = (maxidx - content[binX-1])/2;
+
+    /// ID of the first point of every column, and first
+    /// populated row of every column
+    std::vector<G4int> first_id(nbins_), base(nbins_);
+    num_points_ = 0;
+    for (G4int i=0; i<nbins_; i++) {
+      first_id[i] = num_points_;
+      base[i] = (nbins_ - columns[i])/2;
+      num_points_ += columns[i];
     }
 
-    int sum = 0;
-    for (int i=0; i<binX-1; i++){
-      sum = sum + content[i];
+    point_index_.assign(nbins_*nbins_, 0);
+
+    for (G4int i=0; i<nbins_; i++) {
+      for (G4int j=0; j<nbins_; j++) {
+
+        // The closest EL point of every column is found by clamping
+        // the row to the populated range; the closest of them all
+        // gives the point for cells outside the circle
+        G4int best_i = i, best_j = j;
+        if (j < base[i] || j >= base[i] + columns[i]) {
+          G4int min_dist = std::numeric_limits<G4int>::max();
+          for (G4int k=0; k<nbins_; k++) {
+            if (columns[k] == 0) continue;
+            G4int l = std::min(std::max(j, base[k]), base[k] + columns[k] - 1);
+            G4int dist = (k-i)*(k-i) + (l-j)*(l-j);
+            if (dist < min_dist) {
+              min_dist = dist;
+              best_i = k;
+              best_j = l;
+            }
+          }
+        }
+
+        point_index_[i*nbins_ + j] = first_id[best_i] + best_j - base[best_i];
+      }
     }
-    // The "-1" comes because the EL point IDs start from 0
-    id = sum + binY - base - 1;
+  }
+
+
+
+  G4int ELLookupTable::GetPointID(const G4ThreeVector& hitpos) const
+  {
+    G4int binX = std::floor((hitpos.x() - grid_min_)/pitch_);
+    G4int binY = std::floor((hitpos.y() - grid_min_)/pitch_);
+    binX = std::min(std::max(binX, 0), nbins_-1);
+    binY = std::min(std::max(binY, 0), nbins_-1);
+
+    return point_index_[binX*nbins_ + binY];
+  }
 
-    return ELtable_[id];
+
+
+  ELLookupTable::SensorsMap
+  ELLookupTable::GetSensorsMap(const G4ThreeVector& hitpos) const
+  {
+    G4int id = GetPointID(hitpos);
+    size_t first = offsets_[id];
+    return SensorsMap(sensor_ids_ + first,
+                      probs_ + first*num_tbins_,
+                      offsets_[id+1] - first, num_tbins_);
+  }
+
+
+
+  void ELLookupTable::Print() const
+  {
+    G4cout << "EL lookup table: " << num_points_ << " points with pitch "
+           << pitch_/mm << " mm inside a radius of " << radius_/mm << " mm, "
+           << num_tbins_ << " time bins, " << num_entries_
+           << " sensor entries" << G4endl;
   }
 
 
@@ -14,7 +14,7 @@
 #include <globals.hh>
 
 #include <vector>
-#include <map>
+#include <cstdint>
 
 
 namespace nexus {
@@ -22,7 +22,30 @@ namespace nexus {
   class ELLookupTable: public G4VUserRegionInformation
   {
   public:
-    /// Constructor
+    /// Light detected by the sensors for one EL point: the ID of
+    /// every sensor and its probabilities per time bin
+    class SensorsMap
+    {
+    public:
+      SensorsMap(const G4int* ids, const G4float* probs,
+                 size_t nsensors, G4int ntbins);
+
+      /// Number of sensors seeing light from the EL point
+      size_t size() const;
+      /// ID of the i-th sensor
+      G4int GetSensorID(size_t i) const;
+      /// Probabilities per time bin of the i-th sensor
+      const G4float* GetProbabilities(size_t i) const;
+
+    private:
+      const G4int* ids_;
+      const G4float* probs_;
+      size_t nsensors_;
+      G4int ntbins_;
+    };
+
+  public:
+    /// Constructor. The file can be either in text or in binary format.
     ELLookupTable(G4String);
     /// Destructor
     ~ELLookupTable();
@@ -30,17 +53,82 @@ namespace nexus {
     /// Read input files and store their content in the transient table
     void ReadFiles(G4String);
 
+    /// Map a table in binary format into memory (read-only, so that
+    /// all processes of a node share the same pages)
+    void MapBinaryFile(G4String);
+
+    /// Write the table in binary format
+    void WriteBinaryFile(G4String) const;
+
+    /// Returns true if the file is an EL table in binary format
+    static G4bool IsBinaryFile(G4String);
+
     /// Returns the appropiate sensor map for a given point in the EL gap
-    virtual const std::map<int, std::vector<double> >&
-    GetSensorsMap(const G4ThreeVector&);
+    virtual SensorsMap GetSensorsMap(const G4ThreeVector&) const;
+
+    /// Returns the ID of the EL point closest to a given position
+    G4int GetPointID(const G4ThreeVector&) const;
+
+    /// Returns the number of time bins of the sensor probabilities
+    G4int GetNumberOfTimeBins() const;
 
+    void Print() const;
+
+  private:
+    /// Precompute the EL point ID of every cell of the grid
+    void BuildIndex();
 
   private:
+    // Grid geometry, read from the table header
+    G4double radius_;  ///< Radius of the circle populated with EL points
+    G4double pitch_;   ///< Distance between EL points
+    G4int num_tbins_;  ///< Number of time bins per sensor
 
-    std::vector<std::map<int, std::vector<double> > > ELtable_;
+    G4int nbins_;        ///< Number of grid cells per axis
+    G4double grid_min_;  ///< Lower edge of the grid along x and y
+    G4int num_points_;   ///< Number of EL points inside the circle
 
+    /// EL point ID for every cell of the grid (x-major order). Cells
+    /// outside the populated circle hold the ID of the closest EL point.
+    std::vector<G4int> point_index_;
+
+    /// Sensors of EL point i are those in [offsets_[i], offsets_[i+1])
+    const uint64_t* offsets_;
+    const G4int* sensor_ids_;
+    /// num_tbins_ probabilities per sensor
+    const G4float* probs_;
+    uint64_t num_entries_; ///< Number of (point, sensor) entries
+
+    // Storage of the table when read from a text file
+    std::vector<uint64_t> offsets_buf_;
+    std::vector<G4int> sensor_ids_buf_;
+    std::vector<G4float> probs_buf_;
+
+    // Memory-mapped binary file
+    void* map_addr_;
+    size_t map_size_;
   };
 
+
+  // INLINE METHODS //////////////////////////////////////////////////
+
+  inline ELLookupTable::SensorsMap::SensorsMap(const G4int* ids,
+                                               const G4float* probs,
+                                               size_t nsensors, G4int ntbins):
+    ids_(ids), probs_(probs), nsensors_(nsensors), ntbins_(ntbins) {}
+
+  inline size_t ELLookupTable::SensorsMap::size() const
+  { return nsensors_; }
+
+  inline G4int ELLookupTable::SensorsMap::GetSensorID(size_t i) const
+  { return ids_[i]; }
+
+  inline const G4float* ELLookupTable::SensorsMap::GetProbabilities(size_t i) const
+  { return probs_ + i*ntbins_; }
+
+  inline G4int ELLookupTable::GetNumberOfTimeBins() const
+  { return num_tbins_; }
+
 } // end namespace nexus
 
 #endif
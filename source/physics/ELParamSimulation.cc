@@ -1,7 +1,10 @@
 // ----------------------------------------------------------------------------
 // nexus | ELParamSimulation.cc
 //
-// This class (WIP) implements a parametrized simulation .
+// This class implements a parametrized simulation of the EL light.
+// Ionization electrons reaching the EL region are killed, and the
+// sensors are filled directly with the light they would have detected,
+// as given by an EL look-up table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -10,8 +13,26 @@
 
 #include "ELLookupTable.h"
 #include "IonizationElectron.h"
+#include "UniformElectricDriftField.h"
+#include "SensorSD.h"
 
-#include <G4RunManager.hh>
+#include <G4GenericMessenger.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4Poisson.hh>
+#include <G4AutoLock.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <map>
+#include <set>
+#include <cmath>
+
+
+namespace {
+  // Look-up tables already loaded, indexed by file name, so
+  // that every thread does not read its own copy
+  std::map<G4String, std::shared_ptr<const nexus::ELLookupTable>> tables;
+  G4Mutex tablesMutex = G4MUTEX_INITIALIZER;
+}
 
 
 namespace nexus {
@@ -19,22 +40,31 @@ namespace nexus {
 
   ELParamSimulation::ELParamSimulation(G4Region* region):
     G4VFastSimulationModel("ELParamSimulation", region),
-    table_(0)
+    msg_(0), region_(region), table_file_(""), gain_(0.),
+    field_gain_(0.), time_binning_(200.*ns)
   {
-    // check whether the region has an EL look-up table attached
-    table_ = dynamic_cast<ELLookupTable*>(region->GetUserInformation());
-    // if (!table_) {
-    //   G4String msg = "ERROR: no EL lookup table attached to the region!";
-    //   G4Exception("[ELParamSimulation]", "ELParamSimulation()",
-    // 		  FatalException, msg);
-    // }
+    msg_ = new G4GenericMessenger(this, "/Physics/ELParamSimulation/",
+      "Control commands of the parametrized EL simulation.");
+
+    msg_->DeclareProperty("table", table_file_,
+      "EL look-up table file (text or binary format).");
+
+    msg_->DeclareProperty("gain", gain_,
+      "Mean number of EL photons per ionization electron (if not positive, it is computed from the EL field).");
 
+    G4GenericMessenger::Command& tbin_cmd =
+      msg_->DeclareProperty("time_binning", time_binning_,
+        "Width of the time bins of the EL look-up table.");
+    tbin_cmd.SetParameterName("time_binning", false);
+    tbin_cmd.SetUnitCategory("Time");
+    tbin_cmd.SetRange("time_binning>0.");
   }
 
 
 
   ELParamSimulation::~ELParamSimulation()
   {
+    delete msg_;
   }
 
 
@@ -53,43 +83,87 @@ namespace nexus {
 
 
 
-  void ELParamSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& /*fstep*/)
+  void ELParamSimulation::Initialize()
   {
-    // Get spatial coordinates
-    G4ThreeVector position = ftrack.GetPrimaryTrack()->GetPosition();
-
-    G4cout << "position = " << position << G4endl;
-
-
-    //table_->GetSensorsMap()
-
-    //if (HCE_.size() == 0) {
-
-      G4HCofThisEvent* hce =
-	G4RunManager::GetRunManager()->GetCurrentEvent()->GetHCofThisEvent();
-
-      //}
-
-
-    G4cout << "No of collections: " << hce->GetNumberOfCollections() << G4endl;
-
-
-    G4cout << "here" << G4endl;
-
-
-    ///FIXME. Parameters to be put in some other place
-    // G4int fNum_tbins = 5;
-    // G4double fBinWidth = 200.;
-    // G4int gain = 1170;
-
-    // Get track coordinates
-    // ...
+    if (table_file_ == "") {
+      G4Exception("[ELParamSimulation]", "Initialize()", FatalException,
+        "No EL look-up table was set.");
+    }
+
+    {
+      G4AutoLock lock(&tablesMutex);
+      std::shared_ptr<const ELLookupTable>& table = tables[table_file_];
+      if (!table) table = std::make_shared<ELLookupTable>(table_file_);
+      table_ = table;
+    }
+
+    // Gain of the field of the region, used unless set by the user
+    UniformElectricDriftField* field =
+      dynamic_cast<UniformElectricDriftField*>(region_->GetUserInformation());
+    if (field) {
+      field_gain_ = field->LightYield() *
+        std::abs(field->GetAnodePosition() - field->GetCathodePosition());
+    }
+
+    // Sensitive detectors of this thread
+    std::set<SensorSD*> sds;
+    for (auto lv: *G4LogicalVolumeStore::GetInstance()) {
+      SensorSD* sd = dynamic_cast<SensorSD*>(lv->GetSensitiveDetector());
+      if (sd) sds.insert(sd);
+    }
+
+    for (auto sd: sds)
+      for (auto& sensor: sd->GetSensorPositions())
+        sensors_[sensor.first] = sd;
+  }
 
-    // Ask table for the right sensor map
-    // ...
 
-    // Fill SensorHits according to this map
 
+  void ELParamSimulation::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    if (!table_) Initialize();
+
+    const G4Track* track = ftrack.GetPrimaryTrack();
+    G4ThreeVector position = track->GetPosition();
+    G4double time = track->GetGlobalTime();
+    // The gain set by the user is read every time, so that it can be
+    // changed between events. Ionization electrons tracked in clusters
+    // carry their number as weight.
+    G4double gain = (gain_ > 0.) ? gain_ : field_gain_;
+    if (gain <= 0.) {
+      G4Exception("[ELParamSimulation]", "DoIt()", FatalException,
+        "No gain was set and the EL region has no uniform field.");
+    }
+    gain *= track->GetWeight();
+
+    // The ionization electron is replaced by the light it produces
+    fstep.KillPrimaryTrack();
+    fstep.ProposePrimaryTrackPathLength(0.);
+
+    ELLookupTable::SensorsMap sensors = table_->GetSensorsMap(position);
+    G4int num_tbins = table_->GetNumberOfTimeBins();
+
+    for (size_t i=0; i<sensors.size(); ++i) {
+      G4int sensor_id = sensors.GetSensorID(i);
+
+      auto sd = sensors_.find(sensor_id);
+      if (sd == sensors_.end()) {
+        G4String msg = "Sensor " + std::to_string(sensor_id)
+          + " of the EL look-up table is not in the geometry.";
+        G4Exception("[ELParamSimulation]", "DoIt()", JustWarning, msg);
+        sensors_[sensor_id] = nullptr;
+        continue;
+      }
+      if (!sd->second) continue;
+
+      const G4float* probs = sensors.GetProbabilities(i);
+      for (G4int k=0; k<num_tbins; ++k) {
+        G4int counts = (G4int) G4Poisson(gain * probs[k]);
+        if (counts > 0)
+          sd->second->FillSensor(sensor_id, time + (k+0.5)*time_binning_,
+                                 counts);
+      }
+    }
   }
 
 
@@ -1,7 +1,10 @@
 // ----------------------------------------------------------------------------
 // nexus | ELParamSimulation.h
 //
-// This class (WIP) implements a parametrized simulation .
+// This class implements a parametrized simulation of the EL light.
+// Ionization electrons reaching the EL region are killed, and the
+// sensors are filled directly with the light they would have detected,
+// as given by an EL look-up table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -10,13 +13,17 @@
 #define EL_PARAM_SIMULATION_H
 
 #include <G4VFastSimulationModel.hh>
-#include "SensorHit.h"
-#include <vector>
+
+#include <memory>
+#include <unordered_map>
+
+class G4GenericMessenger;
 
 
 namespace nexus {
 
   class ELLookupTable;
+  class SensorSD;
 
   class ELParamSimulation: public G4VFastSimulationModel
   {
@@ -26,42 +33,36 @@ namespace nexus {
     /// Destructor
     ~ELParamSimulation();
 
-    // This model is only valid for ionization electrons
+    /// This model is only valid for ionization electrons
     G4bool IsApplicable(const G4ParticleDefinition&);
 
-    // You have to return "true" when the dynamics conditions to trigger your
-    // parameterisation are fulfilled. The G4FastTrack provides you access to
-    // the current G4Track, gives simple access to envelope related features
-    // (G4LogicalVolume, G4VSolid, G4AffineTransform references between the
-    // global and the envelope local coordinates systems) and simple access to
-    // the position, momentum expressed in the envelope coordinate system.
-    // Using those quantities and the G4VSolid methods, you can for example
-    // easily check how far you are from the envelope boundary.
-    G4bool ModelTrigger(const G4FastTrack &);
-
-    // Your parameterisation properly said. The G4FastTrack reference provides
-    // input informations. The final state of the particles after parameterisation
-    // has to be returned through the G4FastStep reference. This final state is
-    // described has "requests" the tracking will apply after your
-    // parameterisation has been invoked.
-    void DoIt(const G4FastTrack&, G4FastStep&);
+    /// The model is triggered as soon as an ionization
+    /// electron enters the EL region
+    G4bool ModelTrigger(const G4FastTrack&);
 
-    //To load EL table
-    // void ReadELTable(const char* filename,
-    // 		     std::map<int, std::map<int, std::vector<double> > >& eltable);
+    /// Kill the ionization electron and fill the sensors
+    /// with the light predicted by the look-up table
+    void DoIt(const G4FastTrack&, G4FastStep&);
 
+  private:
+    /// Load the look-up table and find the sensors it refers to
+    void Initialize();
 
   private:
-    //BaseELGrid* elgrid_;
-    // std::map<G4int, std::map<G4int, std::vector<G4double> > >  eltable_;
+    G4GenericMessenger* msg_;
 
-    // bool timebinning_;
-    // int num_tbins_;
+    G4Region* region_;
 
-    ELLookupTable* table_;
+    G4String table_file_;   ///< Name of the EL look-up table file
+    G4double gain_;         ///< Mean number of EL photons per ionization electron
+    G4double field_gain_;   ///< Gain given by the field of the region
+    G4double time_binning_; ///< Width of the time bins of the table
 
-    std::vector<SensorHitsCollection*> HCE_;
+    /// Look-up table, shared by all the threads
+    std::shared_ptr<const ELLookupTable> table_;
 
+    /// Sensitive detector of every sensor, indexed by sensor ID
+    std::unordered_map<G4int, SensorSD*> sensors_;
   };
 
 } // end namespace nexus
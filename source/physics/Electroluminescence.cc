@@ -27,11 +27,13 @@ using namespace CLHEP;
 
 Electroluminescence::Electroluminescence(const G4String& process_name,
 					                               G4ProcessType type):
-  G4VDiscreteProcess(process_name, type), theFastIntegralTable_(0),
-  table_generation_(false), photons_per_point_(0)
+  G4VDiscreteProcess(process_name, type),
+  table_generation_(false), photons_per_point_(0), max_photons_(0)
 {
   ParticleChange_ = new G4ParticleChange();
   pParticleChange = ParticleChange_;
+  // Photon bunches carry their own weight
+  ParticleChange_->SetSecondaryWeightByProcess(true);
 
   BuildThePhysicsTable();
 
@@ -42,6 +44,8 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
 			"EL Table generation");
   msg_->DeclareProperty("photons_per_point", photons_per_point_,
 			"Photon per point");
+  msg_->DeclareProperty("photon_bunches", max_photons_,
+			"Maximum number of photons tracked per step, each one standing for a bunch of photons (0 = all photons tracked).");
 
  }
 
@@ -49,7 +53,6 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
 
 Electroluminescence::~Electroluminescence()
 {
-  delete theFastIntegralTable_;
 }
 
 
@@ -61,17 +64,28 @@ G4bool Electroluminescence::IsApplicable(const G4ParticleDefinition& pdef)
 
 
 
+void Electroluminescence::BuildPhysicsTable(const G4ParticleDefinition&)
+{
+  // Include the spectra of the materials defined
+  // after the construction of the process, if any
+  if (spectra_.size() < G4Material::GetNumberOfMaterials())
+    BuildThePhysicsTable();
+
+  lookup_.Build();
+}
+
+
+
 G4VParticleChange*
 Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 {
   // Initialize particle change with current track values
   ParticleChange_->Initialize(track);
 
-  // Get the current region and its associated drift field.
+  // Get the drift field associated to the current region.
   // If no drift field is defined, kill the track and leave
-  G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
   BaseDriftField* field =
-    dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    lookup_.GetField(*track.GetVolume()->GetLogicalVolume());
   if (!field) {
     ParticleChange_->ProposeTrackStatus(fStopAndKill);
     return G4VDiscreteProcess::PostStepDoIt(track, step);
@@ -84,8 +98,9 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   if (yield <= 0.)
     return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  // Generate a random number of photons around mean 'yield'
-  G4double mean = yield * step_length;
+  // Generate a random number of photons around mean 'yield'.
+  // Ionization electrons tracked in clusters carry their number as weight.
+  G4double mean = yield * step_length * track.GetWeight();
 
   G4int num_photons;
 
@@ -100,6 +115,18 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   if (table_generation_)
     num_photons = photons_per_point_;
 
+  // In bunch mode, every photon tracked stands for 'weight' photons,
+  // and the last one for the remainder, so the total is preserved
+  G4int weight = 1;
+  G4int last_weight = 1;
+  if (max_photons_ > 0 && num_photons > max_photons_) {
+    weight = (num_photons + max_photons_ - 1) / max_photons_;
+    last_weight = num_photons % weight;
+    num_photons = num_photons / weight;
+    if (last_weight > 0) num_photons++;
+    else last_weight = weight;
+  }
+
   ParticleChange_->SetNumberOfSecondaries(num_photons);
 
   // Track secondaries first to avoid a memory bloat
@@ -117,62 +144,30 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   G4double time_end = step.GetPostStepPoint()->GetGlobalTime();
   G4LorentzVector final_position(position_end, time_end);
 
-  // Energy is sampled from integral (like it is
-  // done in G4Scintillation)
+  // Energy is sampled from the integral of the spectrum (like it
+  // is done in G4Scintillation). The sampler is empty for materials
+  // without an EL spectrum.
   G4Material* mat = step.GetPostStepPoint()->GetTouchable()->GetVolume()->GetLogicalVolume()->GetMaterial();
-  G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
-  const G4MaterialPropertyVector* spectrum = mpt->GetProperty("ELSPECTRUM");
 
-  if (!spectrum) return G4VDiscreteProcess::PostStepDoIt(track, step);
-
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-    (G4PhysicsOrderedFreeVector*)(*theFastIntegralTable_)(mat->GetIndex());
+  const SpectrumSampler& spectrum = spectra_[mat->GetIndex()];
 
+  if (spectrum.IsEmpty())
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  // Directions (EL is supposed isotropic), polarizations
+  // and energies of all the photons of the step
+  photons_.Generate(num_photons, spectrum);
 
   for (G4int i=0; i<num_photons; i++) {
-    // Generate a random direction for the photon
-    // (EL is supposed isotropic)
-    G4double cos_theta = 1. - 2.*G4UniformRand();
-    G4double sin_theta = sqrt((1.-cos_theta)*(1.+cos_theta));
-
-    G4double phi = twopi * G4UniformRand();
-    G4double sin_phi = sin(phi);
-    G4double cos_phi = cos(phi);
-
-    G4double px = sin_theta * cos_phi;
-    G4double py = sin_theta * sin_phi;
-    G4double pz = cos_theta;
-
-    G4ThreeVector momentum(px, py, pz);
-
-    // Determine photon polarization accordingly
-    G4double sx = cos_theta * cos_phi;
-    G4double sy = cos_theta * sin_phi;
-    G4double sz = -sin_theta;
-
-    G4ThreeVector polarization(sx, sy, sz);
-    G4ThreeVector perp = momentum.cross(polarization);
-
-    phi = twopi * G4UniformRand();
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-
-    polarization = cos_phi * polarization + sin_phi * perp;
-    polarization = polarization.unit();
-
     // Generate a new photon and set properties
     G4DynamicParticle* photon =
-      new G4DynamicParticle(G4OpticalPhoton::Definition(), momentum);
+      new G4DynamicParticle(G4OpticalPhoton::Definition(),
+                            photons_.GetDirection(i));
 
+    G4ThreeVector polarization = photons_.GetPolarization(i);
     photon->
       SetPolarization(polarization.x(), polarization.y(), polarization.z());
-
-    // Determine photon energy
-    G4double sc_value = G4UniformRand()*sc_max;
-    G4double sampled_energy = spectrum_integral->GetEnergy(sc_value);
-    photon->SetKineticEnergy(sampled_energy);
+    photon->SetKineticEnergy(photons_.GetEnergy(i));
 
     G4LorentzVector xyzt =
       field->GeneratePointAlongDriftLine(initial_position, final_position);
@@ -180,6 +175,7 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
     // Create the track
     G4Track* secondary = new G4Track(photon, xyzt.t(), xyzt.v());
     secondary->SetParentID(track.GetTrackID());
+    secondary->SetWeight((i == num_photons-1) ? last_weight : weight);
     ParticleChange_->AddSecondary(secondary);
 
   }
@@ -191,59 +187,26 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 
 void Electroluminescence::BuildThePhysicsTable()
 {
-  if (theFastIntegralTable_) return;
-
   const G4MaterialTable* theMaterialTable = G4Material::GetMaterialTable();
   G4int numOfMaterials = G4Material::GetNumberOfMaterials();
 
-  // create new physics table
+  spectra_.clear();
+  spectra_.reserve(numOfMaterials);
 
-  if(!theFastIntegralTable_)
-    theFastIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+  // The sampler of the EL spectrum of a material is
+  // stored at the position of the material in the table,
+  // and left empty if the material has no EL spectrum
 
   for (G4int i=0 ; i<numOfMaterials; i++) {
 
-  	G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-  	  new G4PhysicsOrderedFreeVector();
-
-  	// Retrieve vector of scintillation wavelength intensity for
-  	// the material from the material's optical properties table.
-
-  	G4Material* material = (*theMaterialTable)[i];
-
-    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
-
-    if (mpt) {
+    G4MaterialPropertiesTable* mpt =
+      (*theMaterialTable)[i]->GetMaterialPropertiesTable();
 
-  	  G4MaterialPropertyVector* theFastLightVector =
-  	    mpt->GetProperty("ELSPECTRUM");
+    G4MaterialPropertyVector* spectrum =
+      mpt ? mpt->GetProperty("ELSPECTRUM") : nullptr;
 
-  	  if (theFastLightVector) {
-        ComputeCumulativeDistribution(*theFastLightVector, *aPhysicsOrderedFreeVector);
-		  }
-  	}
-
-  	// The scintillation integral(s) for a given material
-  	// will be inserted in the table(s) according to the
-  	// position of the material in the material table.
-
-  	theFastIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
-  }
-}
-
-
-
-void Electroluminescence::ComputeCumulativeDistribution(
-  const G4PhysicsOrderedFreeVector& pdf, G4PhysicsOrderedFreeVector& cdf)
-{
-  G4double sum = 0.;
-  cdf.InsertValues(pdf.Energy(0), sum);
-
-  for (unsigned int i=1; i<pdf.GetVectorLength(); ++i) {
-    G4double area =
-      0.5 * (pdf.Energy(i) - pdf.Energy(i-1)) * (pdf[i] + pdf[i-1]);
-    sum = sum + area;
-    cdf.InsertValues(pdf.Energy(i), sum);
+    if (spectrum) spectra_.emplace_back(*spectrum);
+    else          spectra_.emplace_back();
   }
 }
 
@@ -9,8 +9,13 @@
 #ifndef ELECTROLUMINESCENCE_H
 #define ELECTROLUMINESCENCE_H
 
+#include "DriftLookupTable.h"
+#include "SpectrumSampler.h"
+#include "OpticalPhotonBatch.h"
+
 #include <G4VDiscreteProcess.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
+
+#include <vector>
 
 class G4ParticleChange;
 class G4GenericMessenger;
@@ -30,6 +35,10 @@ namespace nexus {
     /// Returns true if particle is an ionization electron
     G4bool IsApplicable(const G4ParticleDefinition&);
 
+    /// Resolves the drift field of every volume and
+    /// the EL spectrum sampler of every material
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
   public:
     /// This is the method that implements the EL light emission
     /// as a post-step process, that is, photons are generated as
@@ -44,18 +53,21 @@ namespace nexus {
     G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
-                                       G4PhysicsOrderedFreeVector&);
 
   private:
     G4ParticleChange* ParticleChange_;
 
-    G4PhysicsTable* theFastIntegralTable_;
+    /// Sampler of the EL spectrum, indexed by material index
+    std::vector<SpectrumSampler> spectra_;
+    OpticalPhotonBatch photons_; ///< Photons generated in a step
+
+    DriftLookupTable lookup_;
 
     G4GenericMessenger* msg_;
 
     G4bool table_generation_;
     G4int photons_per_point_;
+    G4int max_photons_; ///< Maximum number of photons (bunches) per step
   };
 
 } // end namespace nexus
@@ -9,6 +9,7 @@
 #include "IonizationClustering.h"
 
 #include "BaseDriftField.h"
+#include "UniformElectricDriftField.h"
 #include "IonizationElectron.h"
 #include "SegmentPointSampler.h"
 
@@ -18,9 +19,12 @@
 #include <Randomize.hh>
 #include <G4LorentzVector.hh>
 #include <G4Gamma.hh>
+#include <G4GenericMessenger.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+
 
 namespace nexus {
 
@@ -29,7 +33,8 @@ namespace nexus {
 
   IonizationClustering::IonizationClustering(const G4String& process_name,
                                              G4ProcessType type):
-    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0)
+    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0), rnd_(0),
+    msg_(0), cluster_size_(1), fast_drift_(false)
   {
     // Create particle change object
     ParticleChange_ = new G4ParticleChange();
@@ -37,12 +42,25 @@ namespace nexus {
 
     // Create a segment point sample
     rnd_ = new SegmentPointSampler();
+
+    msg_ = new G4GenericMessenger(this, "/Physics/IonizationClustering/",
+      "Control commands of the ionization clustering process.");
+
+    G4GenericMessenger::Command& cluster_cmd =
+      msg_->DeclareProperty("cluster_size", cluster_size_,
+        "Number of ionization electrons tracked together as a single weighted track.");
+    cluster_cmd.SetParameterName("cluster_size", false);
+    cluster_cmd.SetRange("cluster_size>0");
+
+    msg_->DeclareProperty("fast_drift", fast_drift_,
+      "Drift the ionization electrons to the anode of uniform fields (except EL gaps) when they are created.");
   }
 
 
 
   IonizationClustering::~IonizationClustering()
   {
+    delete msg_;
     delete rnd_;
     delete ParticleChange_;
   }
@@ -62,6 +80,13 @@ namespace nexus {
 
 
 
+  void IonizationClustering::BuildPhysicsTable(const G4ParticleDefinition&)
+  {
+    lookup_.Build();
+  }
+
+
+
   G4VParticleChange*
   IonizationClustering::AtRestDoIt(const G4Track& track, const G4Step& step)
   {
@@ -93,10 +118,9 @@ namespace nexus {
     // a drift field defined. Therefore, check whether the current region
     // has a drift field attached, and stop the process if that's not the case.
 
-    G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
+    const G4LogicalVolume& volume = *track.GetVolume()->GetLogicalVolume();
 
-    BaseDriftField* field =
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    BaseDriftField* field = lookup_.GetField(volume);
 
     if (!field) return G4VRestDiscreteProcess::PostStepDoIt(track, step);
 
@@ -131,43 +155,70 @@ namespace nexus {
       num_charges = G4int(G4Poisson(mean));
     }
 
-    ParticleChange_->SetNumberOfSecondaries(num_charges);
-
-    // Track secondaries first
-    if ((track.GetTrackStatus() == fAlive) && num_charges > 0)
-      ParticleChange_->ProposeTrackStatus(fSuspend);
+    // In cluster mode, each track stands for cluster_size_ electrons
+    // (the last one for the remainder), and carries that number as weight
+    G4int num_tracks = num_charges;
+    if (cluster_size_ > 1)
+      num_tracks = (num_charges + cluster_size_ - 1) / cluster_size_;
 
     //////////////////////////////////////////////////////////////////
+    // Calculate position and time of the tracks. We distribute the ie-
+    // along the step except for the depositions associated to gammas,
+    // where we use the post-step point.
 
-    G4ThreeVector momentum_direction(0.,0.,1.);
-    G4double kinetic_energy = 1.*eV;
-
-    // Set pre and post points of the step in the random generator
     G4LorentzVector pre_point(step.GetPreStepPoint()->GetPosition(),
 			                        step.GetPreStepPoint()->GetGlobalTime());
     G4LorentzVector post_point(step.GetPostStepPoint()->GetPosition(),
                   			       step.GetPostStepPoint()->GetGlobalTime());
     rnd_->SetPoints(pre_point, post_point);
 
+    points_.resize(num_tracks);
+    weights_.resize(num_tracks);
 
-    for (G4int i=0; i<num_charges; i++) {
+    for (G4int i=0; i<num_tracks; i++) {
+      if (track.GetDefinition() == G4Gamma::Definition()) points_[i] = post_point;
+      else points_[i] = rnd_->Shoot();
+      weights_[i] = std::min(cluster_size_, num_charges - i*cluster_size_);
+    }
+
+    // In fast drift mode, the charges are drifted to the anode right away
+    // and only those surviving attachment are tracked, from there on.
+    // Charges in an EL gap are tracked as usual.
+    UniformElectricDriftField* uniform_field = fast_drift_ ?
+      lookup_.GetFastDriftField(volume) : nullptr;
+
+    if (uniform_field)
+      num_tracks = DriftToAnode(*uniform_field, *track.GetMaterial());
+
+    //////////////////////////////////////////////////////////////////
+
+    ParticleChange_->SetSecondaryWeightByProcess(cluster_size_ > 1);
+    ParticleChange_->SetNumberOfSecondaries(num_tracks);
+
+    // Track secondaries first
+    if ((track.GetTrackStatus() == fAlive) && num_tracks > 0)
+      ParticleChange_->ProposeTrackStatus(fSuspend);
+
+    G4ThreeVector momentum_direction(0.,0.,1.);
+    G4double kinetic_energy = 1.*eV;
+
+    for (G4int i=0; i<num_tracks; i++) {
 
       G4DynamicParticle* ionielectron =
         new G4DynamicParticle(IonizationElectron::Definition(),
           momentum_direction, kinetic_energy);
 
-      // Calculate position and time. We distribute the ie- along
-      // the step except for the depositions associated to gammas,
-      // where we use the post-step point.
-      G4LorentzVector point;
-      if (track.GetDefinition() == G4Gamma::Definition()) point = post_point;
-      else point = rnd_->Shoot();
-
       G4Track* aSecondaryTrack =
-        new G4Track(ionielectron, point.t(), point.v());
+        new G4Track(ionielectron, points_[i].t(), points_[i].v());
+
+      // Drifted charges are no longer in the volume of the step,
+      // and are located when their tracking starts
+      if (!uniform_field)
+        aSecondaryTrack->
+          SetTouchableHandle(step.GetPreStepPoint()->GetTouchableHandle());
 
-      aSecondaryTrack->
-        SetTouchableHandle(step.GetPreStepPoint()->GetTouchableHandle());
+      if (cluster_size_ > 1)
+        aSecondaryTrack->SetWeight(weights_[i]);
 
       ParticleChange_->AddSecondary(aSecondaryTrack);
     }
@@ -177,6 +228,40 @@ namespace nexus {
 
 
 
+  G4int IonizationClustering::DriftToAnode(UniformElectricDriftField& field,
+                                           const G4Material& material)
+  {
+    // Attachment by impurities, treated as in IonizationDrift
+    G4double attach = lookup_.GetAttachment(material);
+
+    G4int num_tracks = 0;
+
+    for (size_t i=0; i<points_.size(); ++i) {
+      G4LorentzVector& xyzt = points_[i];
+
+      // Charges that do not move would be killed by the drift process
+      if (field.Drift(xyzt) <= 0.) continue;
+
+      G4int num_survivors = weights_[i];
+      if (attach > 0.) {
+        G4double survival = exp(-xyzt.t() / attach);
+        if (num_survivors == 1)
+          num_survivors = (G4UniformRand() < survival) ? 1 : 0;
+        else
+          num_survivors = G4int(CLHEP::RandBinomial::shoot(num_survivors, survival));
+      }
+      if (num_survivors == 0) continue;
+
+      points_[num_tracks]  = xyzt;
+      weights_[num_tracks] = num_survivors;
+      num_tracks++;
+    }
+
+    return num_tracks;
+  }
+
+
+
   G4double IonizationClustering::GetMeanFreePath(const G4Track&,
     G4double, G4ForceCondition* condition)
   {
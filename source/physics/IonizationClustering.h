@@ -9,12 +9,20 @@
 #ifndef IONIZATION_CLUSTERING_H
 #define IONIZATION_CLUSTERING_H
 
+#include "DriftLookupTable.h"
+
 #include <G4VRestDiscreteProcess.hh>
+#include <G4LorentzVector.hh>
+
+#include <vector>
 
+class G4GenericMessenger;
+class G4Material;
 
 namespace nexus {
 
   class SegmentPointSampler;
+  class UniformElectricDriftField;
 
   class IonizationClustering: public G4VRestDiscreteProcess
   {
@@ -35,6 +43,10 @@ namespace nexus {
     /// in the standard electromagnetic version of the process.
     G4bool IsApplicable(const G4ParticleDefinition&);
 
+    /// Resolves the drift field of every volume and the attachment
+    /// of every material
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
     /// Implements the clusterization for energy depositions of
     /// particles in flight
     G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
@@ -55,9 +67,30 @@ namespace nexus {
     /// to be invoked at every step
     G4double GetMeanLifeTime(const G4Track&, G4ForceCondition*);
 
+    /// Moves the charges in points_ to the end of their drift
+    /// and applies attachment, keeping only the surviving ones.
+    /// Returns the number of tracks left.
+    G4int DriftToAnode(UniformElectricDriftField&, const G4Material&);
+
   private:
     G4ParticleChange* ParticleChange_;
     SegmentPointSampler* rnd_;
+
+    G4GenericMessenger* msg_;
+
+    DriftLookupTable lookup_;
+
+    /// Number of ionization electrons per track. Every track is a cluster
+    /// of electrons and carries their number as its weight.
+    G4int cluster_size_;
+
+    /// Drift charges to the anode as they are created instead
+    /// of transporting them through the drift region
+    G4bool fast_drift_;
+
+    // Position, time and weight of the tracks created in a step
+    std::vector<G4LorentzVector> points_;
+    std::vector<G4int> weights_;
   };
 
 } // end namespace nexus
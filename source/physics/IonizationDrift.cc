@@ -17,6 +17,7 @@
 #include <G4TransportationManager.hh>
 #include <G4TouchableHandle.hh>
 #include <G4Navigator.hh>
+#include <Randomize.hh>
 
 
 namespace nexus {
@@ -44,6 +45,13 @@ namespace nexus {
   {
     return ((pdef == *IonizationElectron::Definition())); 
   }
+
+
+
+  void IonizationDrift::BuildPhysicsTable(const G4ParticleDefinition&)
+  {
+    lookup_.Build();
+  }
   
   
   
@@ -51,12 +59,9 @@ namespace nexus {
   {
     G4double step_length = 0.;
     
-    // Get current region
-    G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
-    
-    // Get the drift field attached to this region
-    BaseDriftField* field = 
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    // Get the drift field attached to the region of the current volume
+    BaseDriftField* field =
+      lookup_.GetField(*track.GetVolume()->GetLogicalVolume());
 
     // If the region has no field, the particle won't move 
     // and therefore the step length is zero.
@@ -82,18 +87,29 @@ namespace nexus {
 
       // Simulate attachment by impurities
       
-      G4MaterialPropertiesTable* mpt = 
-        track.GetMaterial()->GetMaterialPropertiesTable();
+      const G4double attach = lookup_.GetAttachment(*track.GetMaterial());
 
-      if (!mpt || !(mpt->ConstPropertyExists("ATTACHMENT"))) { 
+      if (attach < 0.) {
         G4Exception("[IonizationDrift]", "AlongStepDoIt()", JustWarning,
           "No material properties table found. Assuming no attachment.");
       }
       else {
-        const G4double attach = mpt->GetConstProperty("ATTACHMENT");
-        G4double rnd = -attach * log(G4UniformRand());
-        if (xyzt_.t() > rnd) 
-          ParticleChange_->ProposeTrackStatus(fStopAndKill);
+        G4int num_electrons = G4int(track.GetWeight() + 0.5);
+        if (num_electrons <= 1) {
+          G4double rnd = -attach * log(G4UniformRand());
+          if (xyzt_.t() > rnd) 
+            ParticleChange_->ProposeTrackStatus(fStopAndKill);
+        }
+        else {
+          // Cluster of electrons: each of them survives independently
+          G4double survival = exp(-xyzt_.t() / attach);
+          G4int num_survivors =
+            G4int(CLHEP::RandBinomial::shoot(num_electrons, survival));
+          if (num_survivors == 0)
+            ParticleChange_->ProposeTrackStatus(fStopAndKill);
+          else
+            ParticleChange_->ProposeWeight(num_survivors);
+        }
       }
 
       ParticleChange_->ProposeGlobalTime(xyzt_.t());
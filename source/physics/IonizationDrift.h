@@ -10,6 +10,8 @@
 #ifndef IONIZATION_DRIFT_H
 #define IONIZATION_DRIFT_H
 
+#include "DriftLookupTable.h"
+
 #include <G4VContinuousDiscreteProcess.hh>
 
 
@@ -31,6 +33,10 @@ namespace nexus {
     /// The process is applicable only to ionization electrons
     G4bool IsApplicable(const G4ParticleDefinition&);
 
+    /// Resolves the drift field of every volume and the attachment
+    /// of every material
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
     G4VParticleChange* AlongStepDoIt(const G4Track&, const G4Step&);
 
     G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
@@ -50,6 +56,7 @@ namespace nexus {
     G4LorentzVector xyzt_;
     G4ParticleChangeForTransport* ParticleChange_;
     G4Navigator* nav_; ///< Pointer to the G4 navigator for tracking
+    DriftLookupTable lookup_;
   };
 
 } // end namespace nexus
@@ -1,7 +1,12 @@
 // ----------------------------------------------------------------------------
 // nexus | RadiusDependentDriftField.cc
 //
-// Drift field varying with radial coordinate.
+// Drift field varying with radial coordinate. The drift properties are
+// read from a map in (r,z), where r is the distance to the drift axis,
+// which is parallel to z, and z the position where the charge starts
+// drifting. For every node of the map, the file gives the effective
+// drift velocity and diffusion constants of the drift to the anode,
+// and the radial displacement of the charge at arrival.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -9,11 +14,60 @@
 
 #include "RadiusDependentDriftField.h"
 
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+
 using namespace nexus;
 
 
+namespace {
+
+  /// Header of the binary format of the field maps,
+  /// followed by the nodes of the map
+  struct DriftMapHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_r;
+    uint32_t num_z;
+    uint32_t reserved;
+    double r_max; // in mm
+    double z_min; // in mm
+    double z_max; // in mm
+  };
+
+  const char DRIFTMAP_MAGIC[8] = {'N','X','D','R','F','M','A','P'};
+  const uint32_t DRIFTMAP_VERSION = 1;
+
+  /// Corners of the cell of the map used last by the thread.
+  /// Charges from the same energy deposit usually fall in the
+  /// same cell, which is then found without touching the map.
+  /// Being trivial, it is zero-initialized, with no map (ID 0).
+  struct CellCache {
+    uint64_t map_id;
+    G4int ir, iz;
+    RadiusDependentDriftField::Node corners[4]; // (ir,iz), (ir,iz+1), (ir+1,iz), (ir+1,iz+1)
+  };
+
+  G4ThreadLocal CellCache cell_cache;
 
-RadiusDependentDriftField::RadiusDependentDriftField(): BaseDriftField()
+  /// Source of unique IDs for the maps loaded, identifying them in the cache
+  std::atomic<uint64_t> last_map_id(0);
+
+}
+
+
+
+RadiusDependentDriftField::RadiusDependentDriftField(G4double anode_position,
+                                                     G4double cathode_position):
+  BaseDriftField(), anode_pos_(anode_position), cathode_pos_(cathode_position),
+  num_r_(0), num_z_(0), r_max_(0.), z_min_(0.), z_max_(0.),
+  inv_dr_(0.), inv_dz_(0.), map_id_(0)
 {
 }
 
@@ -25,15 +79,170 @@ RadiusDependentDriftField::~RadiusDependentDriftField()
 
 
 
-G4double RadiusDependentDriftField::Drift(G4LorentzVector& /*xyzt*/)
+void RadiusDependentDriftField::LoadFieldMap(const G4String& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.good()) {
+    G4String msg = "Cannot open drift field map " + filename;
+    G4Exception("[RadiusDependentDriftField]", "LoadFieldMap()",
+                FatalException, msg);
+  }
+
+  DriftMapHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, DRIFTMAP_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != DRIFTMAP_VERSION ||
+      header.num_r < 2 || header.num_z < 2 ||
+      header.r_max <= 0. || header.z_max <= header.z_min) {
+    G4String msg = filename + " is not a valid drift field map.";
+    G4Exception("[RadiusDependentDriftField]", "LoadFieldMap()",
+                FatalException, msg);
+  }
+
+  num_r_ = header.num_r;
+  num_z_ = header.num_z;
+  r_max_ = header.r_max * mm;
+  z_min_ = header.z_min * mm;
+  z_max_ = header.z_max * mm;
+  inv_dr_ = (num_r_ - 1) / r_max_;
+  inv_dz_ = (num_z_ - 1) / (z_max_ - z_min_);
+
+  nodes_.resize(num_r_ * num_z_);
+  if (!file.read(reinterpret_cast<char*>(nodes_.data()),
+                 nodes_.size() * sizeof(Node))) {
+    G4String msg = "Drift field map " + filename + " is truncated.";
+    G4Exception("[RadiusDependentDriftField]", "LoadFieldMap()",
+                FatalException, msg);
+  }
+
+  // Drift times and sigmas are divided by the drift velocity and
+  // proportional to the diffusion, which must be positive, so that the
+  // interpolation between nodes is positive as well
+  for (auto& n: nodes_) {
+    if (!(n.drift_velocity > 0. && n.transv_diff >= 0. && n.longit_diff >= 0.) ||
+        !std::isfinite(n.drift_velocity + n.transv_diff + n.longit_diff + n.delta_r)) {
+      G4String msg = filename + " is not a valid drift field map.";
+      G4Exception("[RadiusDependentDriftField]", "LoadFieldMap()",
+                  FatalException, msg);
+    }
+    n.drift_velocity *= mm/microsecond;
+    n.transv_diff    *= mm/std::sqrt(cm);
+    n.longit_diff    *= mm/std::sqrt(cm);
+    n.delta_r        *= mm;
+  }
+
+  map_id_ = ++last_map_id;
+}
+
+
+
+RadiusDependentDriftField::Node
+RadiusDependentDriftField::GetNode(G4double r, G4double z) const
+{
+  // Position in units of the distance between nodes, clamped to the map
+  G4double u = std::min(std::max(r * inv_dr_, 0.), num_r_ - 1.);
+  G4double v = std::min(std::max((z - z_min_) * inv_dz_, 0.), num_z_ - 1.);
+
+  G4int ir = std::min(G4int(u), num_r_ - 2);
+  G4int iz = std::min(G4int(v), num_z_ - 2);
+
+  CellCache& cell = cell_cache;
+
+  if (cell.map_id != map_id_ || cell.ir != ir || cell.iz != iz) {
+    const Node* n = &nodes_[ir*num_z_ + iz];
+    cell.corners[0] = n[0];
+    cell.corners[1] = n[1];
+    cell.corners[2] = n[num_z_];
+    cell.corners[3] = n[num_z_ + 1];
+    cell.map_id = map_id_;
+    cell.ir = ir;
+    cell.iz = iz;
+  }
+
+  // Bilinear interpolation, with the same weights for all the properties
+  G4double fr = u - ir;
+  G4double fz = v - iz;
+  G4double w[4] = {(1.-fr)*(1.-fz), (1.-fr)*fz, fr*(1.-fz), fr*fz};
+
+  Node result = {0.f, 0.f, 0.f, 0.f};
+  for (G4int k=0; k<4; ++k) {
+    const Node& c = cell.corners[k];
+    result.drift_velocity += w[k] * c.drift_velocity;
+    result.transv_diff    += w[k] * c.transv_diff;
+    result.longit_diff    += w[k] * c.longit_diff;
+    result.delta_r        += w[k] * c.delta_r;
+  }
+
+  return result;
+}
+
+
+
+G4double RadiusDependentDriftField::Drift(G4LorentzVector& xyzt)
 {
-  return 0.;
+  // If the origin is not between anode and cathode,
+  // the charge carrier doesn't move
+  if (nodes_.empty() || !CheckCoordinate(xyzt.z()))
+    return 0.;
+
+  // Set the offset according to relative anode-cathode pos
+  G4double secmargin = -1. * micrometer;
+  if (anode_pos_ > cathode_pos_) secmargin = -secmargin;
+
+  G4double x = xyzt.x();
+  G4double y = xyzt.y();
+  G4double r = std::sqrt(x*x + y*y);
+
+  Node node = GetNode(r, xyzt.z());
+
+  // Calculate drift time and distance to anode
+  G4double drift_length = std::fabs(xyzt.z() - anode_pos_);
+  G4double drift_time = drift_length / node.drift_velocity;
+
+  // Calculate longitudinal and transversal deviation due to diffusion
+  G4double sqrt_length = std::sqrt(drift_length);
+  G4double transv_sigma = node.transv_diff * sqrt_length;
+  G4double time_sigma = node.longit_diff * sqrt_length / node.drift_velocity;
+
+  // Radial displacement of the drift line
+  if (r > 0.) {
+    G4double scale = std::max(r + node.delta_r, 0.) / r;
+    x *= scale;
+    y *= scale;
+  }
+
+  G4ThreeVector position(G4RandGauss::shoot(x, transv_sigma),
+                         G4RandGauss::shoot(y, transv_sigma),
+                         anode_pos_ + secmargin);
+
+  G4double time = xyzt.t() + drift_time + G4RandGauss::shoot(0., time_sigma);
+  if (time < 0.) time = xyzt.t() + drift_time;
+
+  // Calculate step length as euclidean distance between initial
+  // and final positions
+  G4double step_length = (position - xyzt.vect()).mag();
+
+  // Set the new time and position of the drifting charge
+  xyzt.set(time, position);
+
+  return step_length;
 }
 
 
 
 G4LorentzVector
-RadiusDependentDriftField::GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&)
+RadiusDependentDriftField::GeneratePointAlongDriftLine(const G4LorentzVector& origin,
+                                                       const G4LorentzVector& end)
+{
+  G4double rnd = G4UniformRand();
+  return origin + rnd * (end - origin);
+}
+
+
+
+G4bool RadiusDependentDriftField::CheckCoordinate(G4double coord) const
 {
-  return G4LorentzVector();
+  G4double max_coord = std::max(anode_pos_, cathode_pos_);
+  G4double min_coord = std::min(anode_pos_, cathode_pos_);
+  return !((coord > max_coord) || (coord < min_coord));
 }
@@ -1,7 +1,12 @@
 // ----------------------------------------------------------------------------
 // nexus | RadiusDependentDriftField.h
 //
-// Drift field varying with radial coordinate.
+// Drift field varying with radial coordinate. The drift properties are
+// read from a map in (r,z), where r is the distance to the drift axis,
+// which is parallel to z, and z the position where the charge starts
+// drifting. For every node of the map, the file gives the effective
+// drift velocity and diffusion constants of the drift to the anode,
+// and the radial displacement of the charge at arrival.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,24 +18,83 @@
 #include "BaseDriftField.h"
 #include <G4LorentzVector.hh>
 
+#include <vector>
+#include <cstdint>
+
 
 namespace nexus {
 
   class RadiusDependentDriftField: public BaseDriftField
   {
   public:
-    /// Constructor
-    RadiusDependentDriftField();
+    /// Drift properties at a node of the map
+    struct Node {
+      G4float drift_velocity; ///< in mm/us in the file
+      G4float transv_diff;    ///< in mm/sqrt(cm) in the file
+      G4float longit_diff;    ///< in mm/sqrt(cm) in the file
+      G4float delta_r;        ///< radial displacement at arrival, in mm in the file
+    };
+
+  public:
+    /// Constructor providing position of anode and cathode along z
+    RadiusDependentDriftField(G4double anode_position=0.,
+                              G4double cathode_position=0.);
     /// Destructor
     ~RadiusDependentDriftField();
 
+    /// Read the map of drift properties from a file in binary format:
+    /// a header (magic "NXDRFMAP", version, number of nodes in r and z,
+    /// maximum r and range of z in mm; see the source file) followed by
+    /// one Node (4 float32) per node, with node (ir,iz) at ir*num_z+iz.
+    /// Nodes are evenly spaced, the first one in r being at r = 0.
+    void LoadFieldMap(const G4String& filename);
+
     virtual G4double Drift(G4LorentzVector&);
 
     virtual G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
 
-    //virtual G4double LightYield() const;
+    /// Drift properties at a given position, interpolated from the map
+    Node GetNode(G4double r, G4double z) const;
+
+    void SetAnodePosition(G4double);
+    G4double GetAnodePosition() const;
+
+    void SetCathodePosition(G4double);
+    G4double GetCathodePosition() const;
+
+  private:
+    /// Returns true if coordinate is between anode and cathode
+    G4bool CheckCoordinate(G4double) const;
+
+  private:
+    G4double anode_pos_;   ///< Anode position along z
+    G4double cathode_pos_; ///< Cathode position along z
+
+    G4int num_r_, num_z_;  ///< Number of nodes along r and z
+    G4double r_max_;       ///< Radius of the last node
+    G4double z_min_, z_max_;
+    G4double inv_dr_, inv_dz_; ///< Inverse of the distance between nodes
+
+    /// Drift properties at the nodes, in Geant4 units
+    std::vector<Node> nodes_;
+    uint64_t map_id_; ///< Unique ID of the map loaded, 0 if none
   };
 
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void RadiusDependentDriftField::SetAnodePosition(G4double p)
+  { anode_pos_ = p; }
+
+  inline G4double RadiusDependentDriftField::GetAnodePosition() const
+  { return anode_pos_; }
+
+  inline void RadiusDependentDriftField::SetCathodePosition(G4double p)
+  { cathode_pos_ = p; }
+
+  inline G4double RadiusDependentDriftField::GetCathodePosition() const
+  { return cathode_pos_; }
+
 } // end namespace nexus
 
 #endif
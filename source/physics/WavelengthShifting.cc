@@ -22,7 +22,7 @@ namespace nexus {
   using namespace CLHEP;
 
   WavelengthShifting::WavelengthShifting(const G4String& name, G4ProcessType type):
-    G4VDiscreteProcess(name, type), wlsIntegralTable_(0)
+    G4VDiscreteProcess(name, type)
   {
     ParticleChange_ = new G4ParticleChange();
     pParticleChange = ParticleChange_;
@@ -36,10 +36,6 @@ namespace nexus {
   WavelengthShifting::~WavelengthShifting()
   {
     delete ParticleChange_;
-    if (wlsIntegralTable_ != 0) {
-      wlsIntegralTable_->clearAndDestroy();
-      delete wlsIntegralTable_;
-    }
     delete WLSTimeGeneratorProfile_;
   }
 
@@ -82,53 +78,24 @@ namespace nexus {
    ParticleChange_->SetNumberOfSecondaries(1);
 
    G4int materialIndex = material->GetIndex();
-   G4PhysicsOrderedFreeVector* WLSIntegral  =
-     (G4PhysicsOrderedFreeVector*)((*wlsIntegralTable_)(materialIndex));
-
-   // Sample the energy randomly
-   G4double wls_max = WLSIntegral->GetMaxValue();
-   G4double wls_value = G4UniformRand()*wls_max;
-   G4double sampledEnergy = WLSIntegral->GetEnergy(wls_value);
-
-   // Generate random photon direction
-   G4double costheta = 1. - 2.*G4UniformRand();
-   G4double sintheta = std::sqrt((1.-costheta)*(1.+costheta));
-
-   G4double phi = twopi*G4UniformRand();
-   G4double sinphi = std::sin(phi);
-   G4double cosphi = std::cos(phi);
-
-   G4double px = sintheta*cosphi;
-   G4double py = sintheta*sinphi;
-   G4double pz = costheta;
-
-   // Create photon momentum direction vector
-   G4ParticleMomentum photonMomentum(px, py, pz);
-
-   // Determine polarization of new photon
-   G4double sx = costheta*cosphi;
-   G4double sy = costheta*sinphi;
-   G4double sz = -sintheta;
-
-   G4ThreeVector photonPolarization(sx, sy, sz);
-   G4ThreeVector perp = photonMomentum.cross(photonPolarization);
+   const SpectrumSampler& WLSSpectrum = wlsSpectra_[materialIndex];
+   if (WLSSpectrum.IsEmpty())
+     return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-   phi = twopi*G4UniformRand();
-   sinphi = std::sin(phi);
-   cosphi = std::cos(phi);
-   photonPolarization = cosphi * photonPolarization + sinphi * perp;
-   photonPolarization = photonPolarization.unit();
+   // Sample the energy, direction and polarization randomly
+   photon_.Generate(1, WLSSpectrum);
 
    // Generate a new photon
    G4DynamicParticle* aWLSPhoton =
      new G4DynamicParticle(G4OpticalPhoton::OpticalPhoton(),
-			   photonMomentum);
+			   photon_.GetDirection(0));
+   G4ThreeVector photonPolarization = photon_.GetPolarization(0);
    aWLSPhoton->SetPolarization
      (photonPolarization.x(),
       photonPolarization.y(),
       photonPolarization.z());
 
-   aWLSPhoton->SetKineticEnergy(sampledEnergy);
+   aWLSPhoton->SetKineticEnergy(photon_.GetEnergy(0));
 
     // Generate new G4Track object and give position of WLS optical photon
    G4double WLSTime = aMaterialPropertiesTable->GetConstProperty("WLSTIMECONSTANT");
@@ -148,22 +115,17 @@ namespace nexus {
 
   void WavelengthShifting::BuildThePhysicsTable()
   {
-    if (wlsIntegralTable_) return;
+    if (!wlsSpectra_.empty()) return;
 
     const G4MaterialTable* theMaterialTable =
       G4Material::GetMaterialTable();
     G4int numOfMaterials = G4Material::GetNumberOfMaterials();
 
-    // create new physics table
-    if(!wlsIntegralTable_)
-      wlsIntegralTable_ = new G4PhysicsTable(numOfMaterials);
+    wlsSpectra_.reserve(numOfMaterials);
 
     // loop for materials
 
     for (G4int i=0 ; i < numOfMaterials; i++) {
-      G4PhysicsOrderedFreeVector* aPhysicsOrderedFreeVector =
-	new G4PhysicsOrderedFreeVector();
-
       // Retrieve vector of WLS wavelength intensity for
       // the material from the material's optical properties table.
       G4Material* aMaterial = (*theMaterialTable)[i];
@@ -171,17 +133,16 @@ namespace nexus {
       G4MaterialPropertiesTable* aMaterialPropertiesTable =
 	aMaterial->GetMaterialPropertiesTable();
 
-      if (aMaterialPropertiesTable) {
-	G4MaterialPropertyVector* theWLSVector =
-	  aMaterialPropertiesTable->GetProperty("WLSCOMPONENT");
-	if (theWLSVector) {
-	  ComputeCumulativeDistribution(*theWLSVector, *aPhysicsOrderedFreeVector);
-	}
-      }
-      // The WLS integral for a given material
-      // will be inserted in the table according to the
-      // position of the material in the material table.
-      wlsIntegralTable_->insertAt(i,aPhysicsOrderedFreeVector);
+      G4MaterialPropertyVector* theWLSVector = aMaterialPropertiesTable ?
+	aMaterialPropertiesTable->GetProperty("WLSCOMPONENT") : nullptr;
+
+      // The WLS sampler for a given material is inserted
+      // according to the position of the material in the
+      // material table, and left empty if there is no spectrum.
+      if (theWLSVector && (*theWLSVector)[0] >= 0.0)
+	wlsSpectra_.emplace_back(*theWLSVector);
+      else
+	wlsSpectra_.emplace_back();
     }
   }
 
@@ -213,21 +174,4 @@ namespace nexus {
      return AttenuationLength;
   }
 
-  void WavelengthShifting::ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf,
-							 G4PhysicsOrderedFreeVector& cdf)
-  {
-    if (pdf[0] >= 0.0) {
-      // The first entry of the cumulative distribution function is zero.
-      cdf.InsertValues(pdf.Energy(0), 0.0);
-
-      G4double area_sum = 0.;
-      // loop over all (photon energy, intensity) pairs stored for this material
-      // and add the areas calculated with the trapezoidal rule
-      for (size_t j = 1; j < pdf.GetVectorLength(); j++) {
-	area_sum = cdf[j-1] + (pdf[j-1] + pdf[j]) * (pdf.Energy(j) - pdf.Energy(j-1)) * 0.5 ;
-	cdf.InsertValues(pdf.Energy(j), area_sum);
-      }
-    }
-  }
-
 }
@@ -12,8 +12,12 @@
 #ifndef WLS_H
 #define WLS_H
 
+#include "SpectrumSampler.h"
+#include "OpticalPhotonBatch.h"
+
 #include <G4VDiscreteProcess.hh>
-#include <G4PhysicsOrderedFreeVector.hh>
+
+#include <vector>
 
 class G4ParticleChange;
 class G4VWLSTimeGeneratorProfile;
@@ -34,11 +38,12 @@ namespace nexus {
 
   private:
     void BuildThePhysicsTable();
-    void ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf, G4PhysicsOrderedFreeVector& cdf);
 
   private:
     G4ParticleChange* ParticleChange_;
-    G4PhysicsTable* wlsIntegralTable_;
+    /// Sampler of the WLS emission spectrum, indexed by material index
+    std::vector<SpectrumSampler> wlsSpectra_;
+    OpticalPhotonBatch photon_; ///< Properties of the shifted photon
     G4VWLSTimeGeneratorProfile*  WLSTimeGeneratorProfile_;
 
   };
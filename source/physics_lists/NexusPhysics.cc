@@ -14,6 +14,7 @@
 #include "Electroluminescence.h"
 #include "WavelengthShifting.h"
 #include "OpPhotoelectricEffect.h"
+#include "ELParamSimulation.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4OpticalPhoton.hh>
@@ -22,6 +23,7 @@
 #include <G4StepLimiter.hh>
 #include <G4FastSimulationManagerProcess.hh>
 #include <G4PhysicsConstructorFactory.hh>
+#include <G4RegionStore.hh>
 
 
 namespace nexus {
@@ -34,7 +36,8 @@ namespace nexus {
 
   NexusPhysics::NexusPhysics():
     G4VPhysicsConstructor("NexusPhysics"),
-    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false)
+    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false),
+    el_param_(false)
   {
     msg_ = new G4GenericMessenger(this, "/PhysicsList/Nexus/",
       "Control commands of the nexus physics list.");
@@ -51,6 +54,9 @@ namespace nexus {
     msg_->DeclareProperty("photoelectric", photoelectric_,
       "Switch on/off the photoelectric effect.");
 
+    msg_->DeclareProperty("el_parametrization", el_param_,
+      "Switch on/off the parametrized EL simulation in the EL_REGION.");
+
   }
 
 
@@ -109,6 +115,23 @@ namespace nexus {
       pmanager->AddDiscreteProcess(el);
     }
 
+    // Ionization electrons entering the EL region are handed over to the
+    // parametrized EL simulation, which takes precedence over the
+    // electroluminescence process. The model is owned by the region.
+    if (el_param_) {
+      G4Region* el_region =
+        G4RegionStore::GetInstance()->GetRegion("EL_REGION", false);
+      if (!el_region) {
+        G4Exception("[NexusPhysics]", "ConstructProcess()", FatalException,
+          "The parametrized EL simulation requires a region named EL_REGION.");
+      }
+      new ELParamSimulation(el_region);
+
+      G4FastSimulationManagerProcess* fastsim =
+        new G4FastSimulationManagerProcess("fastSimProcess_massGeom");
+      pmanager->AddDiscreteProcess(fastsim);
+    }
+
 
     // Add clustering to all pertinent particles
 
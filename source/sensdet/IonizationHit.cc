@@ -13,10 +13,6 @@
 namespace nexus {
 
 
-  G4Allocator<IonizationHit> IonizationHitAllocator;
-
-
-
   IonizationHit::IonizationHit(): G4VHit()
   {
   }
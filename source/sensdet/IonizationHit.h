@@ -12,9 +12,10 @@
 
 #include <G4VHit.hh>
 #include <G4THitsCollection.hh>
-#include <G4Allocator.hh>
 #include <G4ThreeVector.hh>
 
+#include "EventArena.h"
+
 
 namespace nexus {
 
@@ -61,16 +62,15 @@ namespace nexus {
 
 
   typedef G4THitsCollection<IonizationHit> IonizationHitsCollection;
-  extern G4Allocator<IonizationHit> IonizationHitAllocator;
 
 
   // INLINE DEFINITIONS //////////////////////////////////////////////
 
-  inline void* IonizationHit::operator new(size_t)
-  { return ((void*) IonizationHitAllocator.MallocSingle()); }
+  inline void* IonizationHit::operator new(size_t size)
+  { return EventArena::Instance().Allocate(size, alignof(IonizationHit)); }
 
   inline void IonizationHit::operator delete(void* aHit)
-  { IonizationHitAllocator.FreeSingle((IonizationHit*) aHit); }
+  { EventArena::Deallocate(aHit); }
 
   inline G4int IonizationHit::GetTrackID() { return track_id_; }
   inline void IonizationHit::SetTrackID(G4int id) { track_id_ = id; }
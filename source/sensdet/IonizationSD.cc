@@ -103,3 +103,12 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 void IonizationSD::EndOfEvent(G4HCofThisEvent*)
 {
 }
+
+
+
+G4VSensitiveDetector* IonizationSD::Clone() const
+{
+  IonizationSD* sd = new IonizationSD(GetFullPathName());
+  sd->IncludeInTotalEnergyDeposit(include_);
+  return sd;
+}
@@ -8,23 +8,29 @@
 
 #include "SensorHit.h"
 
+#include <cmath>
+#include <algorithm>
 
-using namespace nexus;
 
+using namespace nexus;
 
-G4Allocator<SensorHit> SensorHitAllocator;
 
+namespace {
+  /// Maximum number of bins of the dense part of the histogram
+  const int64_t MAX_DENSE_BINS = 4096;
+}
 
 
 SensorHit::SensorHit():
-  G4VHit(), pmt_id_(-1.), bin_size_(0.)
+  G4VHit(), pmt_id_(-1.), bin_size_(0.), first_bin_(0)
 {
 }
 
 
 
 SensorHit::SensorHit(G4int id, const G4ThreeVector& position, G4double bin_size):
-  G4VHit(), pmt_id_(id),  bin_size_(bin_size), position_(position)
+  G4VHit(), pmt_id_(id),  bin_size_(bin_size), position_(position),
+  first_bin_(0)
 {
 }
 
@@ -48,7 +54,9 @@ const SensorHit& SensorHit::operator=(const SensorHit& other)
   pmt_id_    = other.pmt_id_;
   bin_size_  = other.bin_size_;
   position_  = other.position_;
-  histogram_ = other.histogram_;
+  first_bin_ = other.first_bin_;
+  counts_    = other.counts_;
+  sparse_    = other.sparse_;
 
   return *this;
 }
@@ -64,7 +72,7 @@ G4int SensorHit::operator==(const SensorHit& other) const
 
 void SensorHit::SetBinSize(G4double bin_size)
 {
-  if (histogram_.size() == 0) {
+  if (counts_.empty()) {
     bin_size_ = bin_size;
   }
   else {
@@ -77,6 +85,53 @@ void SensorHit::SetBinSize(G4double bin_size)
 
 void SensorHit::Fill(G4double time, G4int counts)
 {
-  G4double time_bin = floor(time/bin_size_) * bin_size_;
-  histogram_[time_bin] += counts;
+  if (!(bin_size_ > 0.)) {
+    G4String msg = "The bin size of a SensorHit must be set before filling it.";
+    G4Exception("[SensorHit]", "Fill()", FatalException, msg);
+  }
+
+  int64_t bin = (int64_t) std::floor(time/bin_size_);
+
+  if (counts_.empty()) {
+    first_bin_ = bin;
+    counts_.reserve(64);
+    counts_.push_back(counts);
+    return;
+  }
+
+  const int64_t first = std::min(bin, first_bin_);
+  const int64_t last  = std::max(bin + 1, first_bin_ + (int64_t) counts_.size());
+
+  // Bins that would make the dense range too long are kept apart. The
+  // dense range only grows, so it never reaches the bins kept apart.
+  if (last - first > MAX_DENSE_BINS) {
+    auto it = std::lower_bound(sparse_.begin(), sparse_.end(), bin,
+      [](const std::pair<int64_t, G4int>& b, int64_t i) { return b.first < i; });
+    if (it != sparse_.end() && it->first == bin) it->second += counts;
+    else sparse_.insert(it, std::make_pair(bin, counts));
+    return;
+  }
+
+  // Grow the histogram to cover the new bin. Photons mostly arrive
+  // in time order, so growing at the front is the rare case.
+  if (bin < first_bin_) {
+    counts_.insert(counts_.begin(), first_bin_ - bin, 0);
+    first_bin_ = bin;
+  }
+  else if (bin - first_bin_ >= (int64_t) counts_.size()) {
+    counts_.resize(bin - first_bin_ + 1, 0);
+  }
+
+  counts_[bin - first_bin_] += counts;
+}
+
+
+
+size_t SensorHit::Histogram::size() const
+{
+  size_t n = hit_.counts_.size() -
+    std::count(hit_.counts_.begin(), hit_.counts_.end(), 0);
+  for (const auto& bin: hit_.sparse_)
+    if (bin.second != 0) ++n;
+  return n;
 }
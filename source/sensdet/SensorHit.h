@@ -11,15 +11,23 @@
 
 #include <G4VHit.hh>
 #include <G4THitsCollection.hh>
-#include <G4Allocator.hh>
 #include <G4ThreeVector.hh>
 
+#include "EventArena.h"
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+
 
 namespace nexus {
 
   class SensorHit: public G4VHit
   {
   public:
+    class Histogram;
+
     /// Default constructor
     SensorHit();
     /// Constructor providing the detector ID and position
@@ -58,33 +66,94 @@ namespace nexus {
     /// Adds counts to a given time bin
     void Fill(G4double time, G4int counts=1);
 
-    const std::map<G4double, G4int>& GetHistogram() const;
+    /// Returns a view of the non-empty bins of the histogram as
+    /// (bin start time, counts) pairs, in increasing order of time
+    Histogram GetHistogram() const;
 
   private:
     G4int pmt_id_;           ///< Detector ID number
     G4double bin_size_;      ///< Size of time bin
     G4ThreeVector position_; ///< Detector position
 
-    /// Sparse histogram with number of photons detected per time bin
-    std::map<G4double, G4int> histogram_;
+    /// Index of the time bin stored in the first element of counts_
+    int64_t first_bin_;
+    /// Dense histogram with number of photons detected per time bin,
+    /// covering the range of bins filled so far up to a maximum span
+    std::vector<G4int, EventArenaAllocator<G4int>> counts_;
+    /// Bins too far from the dense range (for instance, light of a
+    /// delayed decay), as (bin index, counts) pairs sorted by index
+    std::vector<std::pair<int64_t, G4int>,
+                EventArenaAllocator<std::pair<int64_t, G4int>>> sparse_;
+  };
+
+
+  /// Read-only view of the histogram of a SensorHit that iterates over
+  /// its non-empty bins like a std::map<G4double, G4int> would
+  class SensorHit::Histogram
+  {
+  public:
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = std::pair<G4double, G4int>;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = const value_type*;
+      using reference         = const value_type&;
+
+      const_iterator(): h_(nullptr), i_(0), num_before_(0) {}
+      const_iterator(const SensorHit* h, size_t i);
+
+      reference operator*() const { return value_; }
+      pointer operator->() const { return &value_; }
+
+      const_iterator& operator++() { ++i_; Skip(); return *this; }
+      const_iterator operator++(int) { const_iterator tmp(*this); ++(*this); return tmp; }
+
+      bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+      bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+
+    private:
+      /// Moves forward to the next non-empty bin
+      void Skip();
+
+      const SensorHit* h_;
+      /// Position in the sequence of the sparse bins before the
+      /// dense ones, the dense bins and the sparse bins after them
+      size_t i_;
+      size_t num_before_; ///< Number of sparse bins before the dense ones
+      value_type value_;
+    };
+
+    Histogram(const SensorHit& hit): hit_(hit) {}
+
+    const_iterator begin() const { return const_iterator(&hit_, 0); }
+    const_iterator end() const
+    { return const_iterator(&hit_, hit_.counts_.size() + hit_.sparse_.size()); }
+
+    /// Number of non-empty bins
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+  private:
+    const SensorHit& hit_;
   };
 
 } // namespace nexus
 
 
 typedef G4THitsCollection<nexus::SensorHit> SensorHitsCollection;
-extern G4Allocator<nexus::SensorHit> SensorHitAllocator;
 
 
 // INLINE DEFINITIONS ////////////////////////////////////////////////
 
 namespace nexus {
 
-  inline void* SensorHit::operator new(size_t)
-  { return ((void*) SensorHitAllocator.MallocSingle()); }
+  inline void* SensorHit::operator new(size_t size)
+  { return EventArena::Instance().Allocate(size, alignof(SensorHit)); }
 
   inline void SensorHit::operator delete(void* hit)
-  { SensorHitAllocator.FreeSingle((SensorHit*) hit); }
+  { EventArena::Deallocate(hit); }
 
   inline G4int SensorHit::GetPmtID() const { return pmt_id_; }
   inline void SensorHit::SetPmtID(G4int id) { pmt_id_ = id; }
@@ -94,8 +163,46 @@ namespace nexus {
   inline G4ThreeVector SensorHit::GetPosition() const { return position_; }
   inline void SensorHit::SetPosition(const G4ThreeVector& p) { position_ = p; }
 
-  inline const std::map<G4double, G4int>& SensorHit::GetHistogram() const
-  { return histogram_; }
+  inline SensorHit::Histogram SensorHit::GetHistogram() const
+  { return Histogram(*this); }
+
+  inline SensorHit::Histogram::const_iterator::const_iterator(const SensorHit* h,
+                                                              size_t i):
+    h_(h), i_(i), num_before_(0)
+  {
+    const auto& sparse = h_->sparse_;
+    while (num_before_ < sparse.size() &&
+           sparse[num_before_].first < h_->first_bin_) ++num_before_;
+    Skip();
+  }
+
+  inline void SensorHit::Histogram::const_iterator::Skip()
+  {
+    const auto& counts = h_->counts_;
+    const auto& sparse = h_->sparse_;
+    const size_t num_dense = counts.size();
+
+    for (; i_ < num_dense + sparse.size(); ++i_) {
+      int64_t bin;
+      G4int n;
+      if (i_ < num_before_) {
+        bin = sparse[i_].first;
+        n   = sparse[i_].second;
+      }
+      else if (i_ < num_before_ + num_dense) {
+        bin = h_->first_bin_ + (int64_t)(i_ - num_before_);
+        n   = counts[i_ - num_before_];
+      }
+      else {
+        bin = sparse[i_ - num_dense].first;
+        n   = sparse[i_ - num_dense].second;
+      }
+      if (n != 0) {
+        value_ = value_type(bin * h_->bin_size_, n);
+        return;
+      }
+    }
+  }
 
 } // namespace nexus
 
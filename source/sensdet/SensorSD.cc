@@ -14,7 +14,10 @@
 #include <G4ProcessManager.hh>
 #include <G4OpBoundaryProcess.hh>
 #include <G4RunManager.hh>
-#include <G4RunManager.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
 
 
 namespace nexus {
@@ -52,6 +55,8 @@ namespace nexus {
       GetCollectionID(this->GetName()+"/"+this->GetCollectionName(0));
 
     HCE->AddHitsCollection(HCID, HC_);
+
+    hit_index_.clear();
   }
 
 
@@ -67,13 +72,7 @@ namespace nexus {
 
     G4int pmt_id = FindPmtID(touchable);
 
-    SensorHit* hit = 0;
-    for (size_t i=0; i<HC_->entries(); i++) {
-      if ((*HC_)[i]->GetPmtID() == pmt_id) {
-        hit = (*HC_)[i];
-        break;
-      }
-    }
+    SensorHit*& hit = hit_index_[pmt_id];
 
     // If no hit associated to this sensor exists already,
     // create it and set main properties
@@ -85,14 +84,28 @@ namespace nexus {
       HC_->insert(hit);
     }
 
+    // A weighted photon stands for a bunch of photons
     G4double time = step->GetPostStepPoint()->GetGlobalTime();
-    hit->Fill(time);
+    G4int counts = (G4int)(step->GetTrack()->GetWeight() + 0.5);
+    hit->Fill(time, counts);
 
     return true;
   }
 
 
 
+  G4VSensitiveDetector* SensorSD::Clone() const
+  {
+    SensorSD* sd = new SensorSD(GetFullPathName());
+    sd->SetDetectorVolumeDepth(sensor_depth_);
+    sd->SetMotherVolumeDepth(mother_depth_);
+    sd->SetDetectorNamingOrder(naming_order_);
+    sd->SetTimeBinning(timebinning_);
+    return sd;
+  }
+
+
+
   G4int SensorSD::FindPmtID(const G4VTouchable* touchable)
   {
     G4int pmtid = touchable->GetCopyNumber(sensor_depth_);
@@ -104,6 +117,72 @@ namespace nexus {
   }
 
 
+  const std::map<G4int, G4ThreeVector>& SensorSD::GetSensorPositions()
+  {
+    if (sensor_pos_.empty()) {
+      G4VPhysicalVolume* world = G4TransportationManager::
+        GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+      std::vector<G4int> copies;
+      FindSensors(world, G4ThreeVector(), G4RotationMatrix(), copies);
+    }
+    return sensor_pos_;
+  }
+
+
+
+  void SensorSD::FindSensors(const G4VPhysicalVolume* pv,
+                             const G4ThreeVector& mother_pos,
+                             const G4RotationMatrix& mother_rot,
+                             std::vector<G4int>& copies)
+  {
+    // Replicas and parameterised volumes would need the navigator
+    // to compute every copy; they are not supported
+    if (pv->IsReplicated()) return;
+
+    G4ThreeVector pos = mother_pos + mother_rot * pv->GetTranslation();
+    G4RotationMatrix rot = mother_rot * pv->GetObjectRotationValue();
+    copies.push_back(pv->GetCopyNo());
+
+    G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+    // Copy numbers are counted upwards from the sensor volume,
+    // following the same convention as FindPmtID
+    G4int depth = copies.size() - 1;
+    if (lv->GetSensitiveDetector() == this &&
+        depth >= sensor_depth_ && depth >= mother_depth_) {
+      G4int pmtid = copies[depth - sensor_depth_];
+      if (naming_order_ != 0)
+        pmtid = naming_order_ * copies[depth - mother_depth_] + pmtid;
+      sensor_pos_.emplace(pmtid, pos);
+    }
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i)
+      FindSensors(lv->GetDaughter(i), pos, rot, copies);
+
+    copies.pop_back();
+  }
+
+
+
+  void SensorSD::FillSensor(G4int sensor_id, G4double time, G4int counts)
+  {
+    SensorHit*& hit = hit_index_[sensor_id];
+
+    if (!hit) {
+      hit = new SensorHit();
+      hit->SetPmtID(sensor_id);
+      hit->SetBinSize(timebinning_);
+      const std::map<G4int, G4ThreeVector>& positions = GetSensorPositions();
+      auto pos = positions.find(sensor_id);
+      if (pos != positions.end()) hit->SetPosition(pos->second);
+      HC_->insert(hit);
+    }
+
+    hit->Fill(time, counts);
+  }
+
+
+
   void SensorSD::EndOfEvent(G4HCofThisEvent* /*HCE*/)
   {
     //  int HCID = G4SDManager::GetSDMpointer()->
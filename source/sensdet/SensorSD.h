@@ -11,13 +11,19 @@
 #define PMT_SD_H
 
 #include <G4VSensitiveDetector.hh>
+#include <G4RotationMatrix.hh>
 #include "SensorHit.h"
 
+#include <unordered_map>
+#include <map>
+#include <vector>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4VTouchable;
 class G4TouchableHistory;
 class G4OpBoundaryProcess;
+class G4VPhysicalVolume;
 
 
 namespace nexus {
@@ -39,6 +45,10 @@ namespace nexus {
     /// Method invoked at the end of every event
     void EndOfEvent(G4HCofThisEvent*);
 
+    /// Return a new sensitive detector with the same configuration,
+    /// to be used by a worker thread
+    G4VSensitiveDetector* Clone() const;
+
     /// Set the depth of the sensitive detector in the geometry hierarchy
     void SetDetectorVolumeDepth(G4int);
     /// Return the depth of the sensitive detector in the volume hierarchy
@@ -57,6 +67,16 @@ namespace nexus {
     /// Set a time binning for the pmt hits
     void SetTimeBinning(G4double);
 
+    /// Return the position of every sensor this detector is attached to,
+    /// indexed by sensor ID. It is computed on first use walking the
+    /// geometry tree (only volumes placed with G4PVPlacement are found).
+    const std::map<G4int, G4ThreeVector>& GetSensorPositions();
+
+    /// Add counts to the hit of a sensor in the current event, as if
+    /// that many photons had been detected at the given time. This lets
+    /// parametrized simulations fill sensors without tracking photons.
+    void FillSensor(G4int sensor_id, G4double time, G4int counts);
+
     /// Return the unique name of the hits collection created
     /// by this sensitive detector. This will be used by the
     /// persistency manager to select the collection.
@@ -68,6 +88,10 @@ namespace nexus {
 
     G4int FindPmtID(const G4VTouchable*);
 
+    /// Walk the geometry tree below a volume looking for sensors
+    void FindSensors(const G4VPhysicalVolume*, const G4ThreeVector&,
+                     const G4RotationMatrix&, std::vector<G4int>&);
+
     G4int naming_order_; ///< Order of the naming scheme
     G4int sensor_depth_; ///< Depth of the SD in the geometry tree
     G4int mother_depth_; ///< Depth of the SD's mother in the geometry tree
@@ -75,6 +99,12 @@ namespace nexus {
     G4double timebinning_; ///< Time bin width
 
     SensorHitsCollection* HC_; ///< Pointer to the collection of hits
+
+    /// Hit of each sensor in the current event, indexed by sensor ID
+    std::unordered_map<G4int, SensorHit*> hit_index_;
+
+    /// Position of each sensor, indexed by sensor ID
+    std::map<G4int, G4ThreeVector> sensor_pos_;
   };
 
   // INLINE METHODS //////////////////////////////////////////////////
@@ -0,0 +1,149 @@
+#include <Decay0EnergyTable.h>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cmath>
+
+
+TEST_CASE("Decay0EnergyTable") {
+
+  // Energies must be in the window of the energy sum, and a table
+  // loaded from a file must give the same energies as the original
+
+  const G4String filename = "Decay0EnergyTableTests.tab";
+  const std::string key = "test table";
+
+  auto density = [](G4double e1, G4double e2) {
+    G4double q = 2.5 - e1 - e2;
+    return q > 0. ? e1 * e2 * q * q * q * q * q : 0.;
+  };
+
+  nexus::Decay0EnergyTable table;
+  table.Build(density, 0.001, 2.3, 2.5);
+  REQUIRE(table.HasSecondEnergy());
+  REQUIRE(!table.IsEmpty());
+  table.Save(filename, key);
+
+  nexus::Decay0EnergyTable loaded;
+  REQUIRE(!loaded.Load(filename, "other key"));
+  REQUIRE(loaded.Load(filename, key));
+  std::remove(filename.c_str());
+
+  G4long seed = 12345;
+  std::vector<G4double> energies;
+  for (nexus::Decay0EnergyTable* t: {&table, &loaded}) {
+    G4Random::setTheSeed(seed);
+    for (G4int i=0; i<1000; ++i) {
+      G4double e1, e2;
+      REQUIRE(t->Shoot(e1, e2));
+      REQUIRE(e1 >= 0.);
+      REQUIRE(e2 >= 0.);
+      REQUIRE(e1 + e2 >= 2.3);
+      REQUIRE(e1 + e2 <= 2.5);
+      energies.push_back(e1);
+    }
+  }
+  for (G4int i=0; i<1000; ++i)
+    REQUIRE(energies[i] == energies[1000+i]);
+
+  // One-dimensional table, restricted to part of the bins
+  std::vector<G4double> weights = {1., 2., 0., 4.};
+  table.Build(weights, 1., 0.5, 1.25, 2.9);
+  REQUIRE(!table.HasSecondEnergy());
+  for (G4int i=0; i<1000; ++i) {
+    G4double e = table.Shoot();
+    REQUIRE(e >= 1.25);
+    REQUIRE(e < 2.9);
+    REQUIRE((e < 2. || e >= 2.5));
+  }
+}
+
+
+
+TEST_CASE("Decay0EnergyTable distributions") {
+
+  // The sampled energies must follow the density within the statistical
+  // uncertainty: the first energy, as the marginal obtained by integrating
+  // the density in the second one (spthe1_ in decay0), and the sum of
+  // both up to the endpoint, where the bias of the cells is largest.
+  // The density is that of a two-neutrino mode, e1 e2 (q - e1 - e2)^5.
+
+  const G4double q = 2.5, sum_low = 2., sum_high = q;
+
+  auto density = [=](G4double e1, G4double e2) {
+    G4double r = q - e1 - e2;
+    return r > 0. ? e1 * e2 * r * r * r * r * r : 0.;
+  };
+
+  // Simpson's rule
+  auto integrate = [](const std::function<G4double(G4double)>& f,
+                      G4double a, G4double b) {
+    const G4int n = 200;
+    const G4double h = (b - a) / n;
+    G4double sum = f(a) + f(b);
+    for (G4int i=1; i<n; ++i) sum += f(a + i*h) * (i % 2 ? 4. : 2.);
+    return sum * h / 3.;
+  };
+
+  auto marginal = [&](G4double e1) {
+    return integrate([&](G4double e2) { return density(e1, e2); },
+                     std::max(sum_low - e1, 0.), sum_high - e1);
+  };
+
+  // The sum s has a density s^3 (q - s)^5 / 6
+  auto sum_density = [=](G4double s) {
+    return s * s * s * std::pow(q - s, 5) / 6.;
+  };
+
+  nexus::Decay0EnergyTable table;
+  table.Build(density, 0.001, sum_low, sum_high);
+
+  const G4int num_events = 200000;
+  const G4int num_bins = 20;
+  std::vector<G4double> e1_edges, sum_edges;
+  for (G4int i=0; i<=num_bins; ++i) {
+    e1_edges.push_back(i * q / num_bins);
+    sum_edges.push_back(sum_low + i * 0.4 / num_bins);
+  }
+  // The last bin of the sum, up to the endpoint, has few events
+  sum_edges.back() = sum_high;
+
+  std::vector<G4int> e1_counts(num_bins, 0), sum_counts(num_bins, 0);
+  G4Random::setTheSeed(54321);
+  for (G4int i=0; i<num_events; ++i) {
+    G4double e1, e2;
+    REQUIRE(table.Shoot(e1, e2));
+    auto bin = [](const std::vector<G4double>& edges, G4double x) {
+      return std::upper_bound(edges.begin(), edges.end(), x) - edges.begin() - 1;
+    };
+    ++e1_counts[std::min<G4int>(bin(e1_edges, e1), num_bins - 1)];
+    ++sum_counts[std::min<G4int>(bin(sum_edges, e1 + e2), num_bins - 1)];
+  }
+
+  // Chi-square with the expected number of events in each bin, merging
+  // the bins with few events, against the 99.9% quantile for 19 degrees
+  // of freedom (an upper bound if some bins are merged)
+  auto chi2 = [&](const std::function<G4double(G4double)>& f,
+                  const std::vector<G4double>& edges,
+                  const std::vector<G4int>& counts) {
+    std::vector<G4double> expected(num_bins);
+    G4double total = 0.;
+    for (G4int i=0; i<num_bins; ++i) {
+      expected[i] = integrate(f, edges[i], edges[i+1]);
+      total += expected[i];
+    }
+    G4double chi2 = 0., mu = 0., n = 0.;
+    for (G4int i=0; i<num_bins; ++i) {
+      mu += expected[i] * num_events / total;
+      n  += counts[i];
+      if (mu < 10. && i < num_bins - 1) continue;
+      chi2 += (n - mu) * (n - mu) / mu;
+      mu = n = 0.;
+    }
+    return chi2;
+  };
+
+  REQUIRE(chi2(marginal, e1_edges, e1_counts) < 43.8);
+  REQUIRE(chi2(sum_density, sum_edges, sum_counts) < 43.8);
+}
@@ -0,0 +1,52 @@
+#include <Decay0FileReader.h>
+
+#include <catch.hpp>
+
+#include <fstream>
+#include <cstdio>
+
+
+TEST_CASE("Decay0FileReader") {
+
+  const G4String filename = "Decay0FileReaderTests.genbb";
+
+  std::ofstream file(filename);
+  file << " GENBB generated file\n"
+       << " First event and full number of events:\n"
+       << "           1           3\n"
+       << "    \n"
+       << "       0  3214.71       2\n"
+       << "  3 -0.135950       1.11337      0.703691      0.00000    \n"
+       << " 47   104.085       189.402       103.236     0.411172E-03\n"
+       << "       1  491.558       1\n"
+       << "  1  -1.53577      -1.26221      -1.63860      0.00000    \n"
+       << "       2  100.082       2\n"
+       << "  3  0.332183      0.500002     -0.503284E-01  0.00000    \n";
+  file.close();
+
+  // The index is built the first time and loaded the second one.
+  // The last event is incomplete and must be ignored.
+  for (G4int i=0; i<2; ++i) {
+    nexus::Decay0FileReader reader;
+    REQUIRE(reader.Open(filename));
+    REQUIRE(reader.GetNumberOfEvents() == 2);
+
+    nexus::Decay0Event event;
+    REQUIRE(reader.ReadEvent(1, event));
+    REQUIRE(event.number == 1);
+    REQUIRE(event.time == Approx(491.558));
+    REQUIRE(event.particles.size() == 1);
+    REQUIRE(event.particles[0].g3code == 1);
+    REQUIRE(event.particles[0].pz == Approx(-1.63860));
+
+    REQUIRE(reader.ReadEvent(0, event));
+    REQUIRE(event.particles.size() == 2);
+    REQUIRE(event.particles[1].g3code == 47);
+    REQUIRE(event.particles[1].time == Approx(0.411172e-3));
+
+    REQUIRE(!reader.ReadEvent(2, event));
+  }
+
+  std::remove(filename.c_str());
+  std::remove((filename + ".idx").c_str());
+}
@@ -0,0 +1,65 @@
+#include <BoundedQueue.h>
+
+#include <catch.hpp>
+
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+
+TEST_CASE("BoundedQueue single thread") {
+  // The capacity is rounded up to a power of two
+  nexus::BoundedQueue<int> queue(5);
+  REQUIRE(queue.Capacity() == 8);
+
+  int item;
+  REQUIRE(!queue.TryPop(item));
+
+  for (int i=0; i<8; ++i) REQUIRE(queue.TryPush(i));
+  REQUIRE(!queue.TryPush(8));
+  REQUIRE(queue.Size() == 8);
+
+  // Elements come out in the same order they went in
+  for (int i=0; i<8; ++i) {
+    REQUIRE(queue.TryPop(item));
+    REQUIRE(item == i);
+  }
+  REQUIRE(queue.Size() == 0);
+}
+
+
+TEST_CASE("BoundedQueue many producers") {
+  // Every element pushed by several threads is popped exactly once
+  const int nproducers = 4;
+  const int nitems = 10000;
+
+  nexus::BoundedQueue<int> queue(16);
+
+  std::vector<std::thread> producers;
+  for (int p=0; p<nproducers; ++p) {
+    producers.emplace_back([&queue, p]() {
+      for (int i=0; i<nitems; ++i)
+        while (!queue.TryPush(p*nitems + i)) std::this_thread::yield();
+    });
+  }
+
+  std::vector<int> seen(nproducers*nitems, 0);
+  std::vector<int> last(nproducers, -1);
+  bool ordered = true;
+  for (int n=0; n<nproducers*nitems; ) {
+    int item;
+    if (!queue.TryPop(item)) continue;
+    seen[item]++;
+    // Elements from the same producer keep their order
+    if (item % nitems <= last[item / nitems]) ordered = false;
+    last[item / nitems] = item % nitems;
+    n++;
+  }
+
+  for (auto& t: producers) t.join();
+
+  REQUIRE(ordered);
+  REQUIRE(std::accumulate(seen.begin(), seen.end(), 0) == nproducers*nitems);
+  REQUIRE(std::count(seen.begin(), seen.end(), 1) == nproducers*nitems);
+}
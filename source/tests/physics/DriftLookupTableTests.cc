@@ -0,0 +1,50 @@
+#include <DriftLookupTable.h>
+#include <UniformElectricDriftField.h>
+
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Region.hh>
+#include <G4NistManager.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("DriftLookupTable fast drift") {
+
+  // Charges deposited in a uniform drift field can be drifted to its
+  // anode at once, but not those deposited in a field with EL yield,
+  // which must be tracked through it for their light to be generated
+
+  G4Material* xenon = G4NistManager::Instance()->FindOrBuildMaterial("G4_Xe");
+  G4Box* box = new G4Box("BOX", 1.*cm, 1.*cm, 1.*cm);
+
+  nexus::UniformElectricDriftField* drift_field =
+    new nexus::UniformElectricDriftField(0.*cm, 10.*cm);
+  drift_field->SetDriftVelocity(1.*mm/microsecond);
+  G4LogicalVolume* drift_logic = new G4LogicalVolume(box, xenon, "DRIFT");
+  G4Region* drift_region = new G4Region("DRIFT_REGION");
+  drift_region->SetUserInformation(drift_field);
+  drift_region->AddRootLogicalVolume(drift_logic);
+
+  nexus::UniformElectricDriftField* el_field =
+    new nexus::UniformElectricDriftField(-1.*cm, 0.*cm);
+  el_field->SetDriftVelocity(2.5*mm/microsecond);
+  el_field->SetLightYield(100./cm);
+  G4LogicalVolume* el_logic = new G4LogicalVolume(box, xenon, "EL");
+  G4Region* el_region = new G4Region("EL_REGION");
+  el_region->SetUserInformation(el_field);
+  el_region->AddRootLogicalVolume(el_logic);
+
+  G4LogicalVolume* no_field_logic = new G4LogicalVolume(box, xenon, "NO_FIELD");
+
+  nexus::DriftLookupTable lookup;
+  lookup.Build();
+
+  REQUIRE(lookup.GetUniformField(*drift_logic) == drift_field);
+  REQUIRE(lookup.GetUniformField(*el_logic) == el_field);
+
+  REQUIRE(lookup.GetFastDriftField(*drift_logic) == drift_field);
+  REQUIRE(lookup.GetFastDriftField(*el_logic) == nullptr);
+  REQUIRE(lookup.GetFastDriftField(*no_field_logic) == nullptr);
+}
@@ -0,0 +1,82 @@
+#include <RadiusDependentDriftField.h>
+
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+
+TEST_CASE("RadiusDependentDriftField map interpolation") {
+
+  // Bilinear interpolation reproduces exactly a function of the form
+  // a + b*r + c*z + d*r*z, between nodes as well as on them. Outside
+  // the map, the values of its edges are used. All the values in the
+  // map are positive, as required for a valid map.
+
+  auto f = [](G4double r, G4double z, G4double a) {
+    return 10.*a + 0.5*r + 0.25*z + 0.01*r*z;
+  };
+
+  const G4String filename = "RadiusDependentDriftFieldTests.map";
+  const uint32_t num_r = 6, num_z = 5;
+  const G4double r_max = 10., z_min = -20., z_max = 20.; // mm
+
+  std::ofstream file(filename, std::ios::binary);
+  file.write("NXDRFMAP", 8);
+  const uint32_t ints[4] = {1, num_r, num_z, 0};
+  file.write(reinterpret_cast<const char*>(ints), sizeof(ints));
+  const G4double doubles[3] = {r_max, z_min, z_max};
+  file.write(reinterpret_cast<const char*>(doubles), sizeof(doubles));
+  for (uint32_t ir=0; ir<num_r; ++ir) {
+    for (uint32_t iz=0; iz<num_z; ++iz) {
+      G4double r = ir * r_max / (num_r - 1);
+      G4double z = z_min + iz * (z_max - z_min) / (num_z - 1);
+      const float node[4] = {float(f(r, z, 1.)), float(f(r, z, 2.)),
+                             float(f(r, z, 3.)), float(f(r, z, 4.))};
+      file.write(reinterpret_cast<const char*>(node), sizeof(node));
+    }
+  }
+  file.close();
+
+  nexus::RadiusDependentDriftField field(0., 100.);
+  field.LoadFieldMap(filename);
+  std::remove(filename.c_str());
+
+  auto check = [&](G4double r, G4double z, G4double r_map, G4double z_map) {
+    nexus::RadiusDependentDriftField::Node node = field.GetNode(r*mm, z*mm);
+    REQUIRE(node.drift_velocity / (mm/microsecond) ==
+            Approx(f(r_map, z_map, 1.)).epsilon(1.e-5));
+    REQUIRE(node.transv_diff / (mm/std::sqrt(cm)) ==
+            Approx(f(r_map, z_map, 2.)).epsilon(1.e-5));
+    REQUIRE(node.longit_diff / (mm/std::sqrt(cm)) ==
+            Approx(f(r_map, z_map, 3.)).epsilon(1.e-5));
+    REQUIRE(node.delta_r / mm == Approx(f(r_map, z_map, 4.)).epsilon(1.e-5));
+  };
+
+  SECTION ("On the nodes") {
+    check(0., -20., 0., -20.);
+    check(4., 0., 4., 0.);
+    check(10., 20., 10., 20.);
+  }
+
+  SECTION ("Between the nodes") {
+    check(1., -17., 1., -17.);
+    check(3.3, 4.2, 3.3, 4.2);
+    check(9.9, 19.5, 9.9, 19.5);
+    // Alternating cells, so that the cache of the last cell is refreshed
+    check(0.7, -3., 0.7, -3.);
+    check(7.1, 12., 7.1, 12.);
+    check(0.7, -3., 0.7, -3.);
+  }
+
+  SECTION ("Outside the map") {
+    check(15., 0., 10., 0.);
+    check(5., -30., 5., -20.);
+    check(12., 25., 10., 20.);
+    check(-1., 30., 0., 20.);
+  }
+}
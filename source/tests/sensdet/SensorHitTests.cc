@@ -0,0 +1,42 @@
+#include <SensorHit.h>
+
+#include <catch.hpp>
+
+#include <map>
+
+
+TEST_CASE("SensorHit histogram") {
+  // The histogram of a SensorHit must give the same bins and
+  // counts as a sparse map keyed by the bin start time
+
+  const G4double bin_size = 25.;
+  nexus::SensorHit hit(0, G4ThreeVector(), bin_size);
+
+  std::map<G4double, G4int> reference;
+  // Some photons arrive much later (or earlier) than the others,
+  // beyond the span of the dense part of the histogram
+  const G4double times[] = {120., 130., 80., 1010., 5., 130., 2600., 79.,
+                            2.e9, 1.e5, 2.e9+10., -3.e7, 5.e6, 1.e5};
+  for (auto t: times) {
+    hit.Fill(t);
+    reference[std::floor(t/bin_size)*bin_size] += 1;
+  }
+  hit.Fill(400., 3);
+  reference[400.] += 3;
+
+  auto histogram = hit.GetHistogram();
+  REQUIRE(histogram.size() == reference.size());
+
+  auto ref = reference.begin();
+  for (auto it = histogram.begin(); it != histogram.end(); ++it, ++ref) {
+    REQUIRE(it->first  == ref->first);
+    REQUIRE(it->second == ref->second);
+  }
+  REQUIRE(ref == reference.end());
+
+  SECTION ("Copies keep the histogram") {
+    nexus::SensorHit copy(hit);
+    REQUIRE(copy.GetHistogram().size() == reference.size());
+    REQUIRE(copy.GetHistogram().begin()->first == reference.begin()->first);
+  }
+}
@@ -0,0 +1,43 @@
+#include <CellPointSampler.h>
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+TEST_CASE("CellPointSampler") {
+
+  // Points sampled in a cube must fall in the spherical shell given by
+  // the inside function (a sphere without the one inside it, as if it
+  // were a daughter volume), and be uniform in it
+
+  const G4double r_in = 3., r_out = 8.;
+
+  auto map = [](G4double u1, G4double u2, G4double u3) {
+    return G4ThreeVector(20.*u1 - 10., 20.*u2 - 10., 20.*u3 - 10.);
+  };
+  auto inside = [=](const G4ThreeVector& p) {
+    return p.mag() <= r_out && p.mag() >= r_in;
+  };
+  auto safety = [=](const G4ThreeVector& p) {
+    return std::min(std::abs(p.mag() - r_out), std::abs(p.mag() - r_in));
+  };
+
+  nexus::CellPointSampler sampler(map, inside, safety, 4096);
+
+  const G4int n = 100000;
+  const G4double r_half = 5.5;
+  G4int n_half = 0;
+  for (G4int i=0; i<n; ++i) {
+    G4ThreeVector p = sampler.Shoot();
+    REQUIRE(p.mag() <= r_out);
+    REQUIRE(p.mag() >= r_in);
+    if (p.mag() < r_half) ++n_half;
+  }
+
+  // Fraction of the volume of the shell below r_half
+  G4double expected = (std::pow(r_half, 3) - std::pow(r_in, 3)) /
+                      (std::pow(r_out, 3) - std::pow(r_in, 3));
+  REQUIRE(G4double(n_half) / n == Approx(expected).margin(0.01));
+}
@@ -0,0 +1,25 @@
+#include <OpticalPhotonBatch.h>
+
+#include <catch.hpp>
+
+
+TEST_CASE("OpticalPhotonBatch") {
+
+  // Directions and polarizations must be unit vectors,
+  // and the polarization perpendicular to the direction
+
+  nexus::OpticalPhotonBatch batch;
+  batch.Generate(1000);
+  REQUIRE(batch.size() == 1000);
+
+  for (G4int i=0; i<batch.size(); ++i) {
+    G4ThreeVector dir = batch.GetDirection(i);
+    G4ThreeVector pol = batch.GetPolarization(i);
+    REQUIRE(dir.mag() == Approx(1.));
+    REQUIRE(pol.mag() == Approx(1.));
+    REQUIRE(dir.dot(pol) == Approx(0.).margin(1.e-12));
+  }
+
+  batch.Generate(10);
+  REQUIRE(batch.size() == 10);
+}
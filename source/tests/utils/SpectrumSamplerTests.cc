@@ -0,0 +1,43 @@
+#include <SpectrumSampler.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+
+TEST_CASE("SpectrumSampler") {
+
+  SECTION("Empty spectrum") {
+    nexus::SpectrumSampler empty;
+    REQUIRE(empty.IsEmpty());
+
+    nexus::SpectrumSampler zero({1., 2., 3.}, {0., 0., 0.});
+    REQUIRE(zero.IsEmpty());
+  }
+
+  SECTION("Inverse of the cumulative distribution") {
+    // Triangular spectrum between 1 and 3, with a gap of zero intensity
+    std::vector<G4double> energies    = {0., 1., 2., 3.};
+    std::vector<G4double> intensities = {0., 0., 1., 0.};
+    nexus::SpectrumSampler sampler(energies, intensities);
+    REQUIRE(!sampler.IsEmpty());
+
+    REQUIRE(sampler.GetEnergy(0.)   == Approx(1.));
+    REQUIRE(sampler.GetEnergy(0.5)  == Approx(2.));
+    REQUIRE(sampler.GetEnergy(0.25) == Approx(1.5));
+    REQUIRE(sampler.GetEnergy(0.75) == Approx(2.5));
+  }
+
+  SECTION("Random energies within the spectrum") {
+    nexus::SpectrumSampler sampler({2., 2.5, 4.}, {1., 3., 0.5});
+
+    std::vector<G4double> energies(1000);
+    sampler.Shoot(energies.size(), energies.data());
+
+    for (auto e: energies) {
+      REQUIRE(e >= 2.);
+      REQUIRE(e <= 4.);
+    }
+  }
+
+}
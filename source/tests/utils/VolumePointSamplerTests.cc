@@ -0,0 +1,89 @@
+#include <VolumePointSampler.h>
+
+#include <G4Box.hh>
+#include <G4Tubs.hh>
+#include <G4Orb.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4NistManager.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("VolumePointSampler") {
+
+  // Points must fall inside one of the copies of the volume and
+  // outside its daughters, both for tubes (sampled directly) and
+  // for other solids (sampled from cells)
+
+  G4Material* vacuum =
+    G4NistManager::Instance()->FindOrBuildMaterial("G4_Galactic");
+
+  G4Box* world_solid = new G4Box("WORLD", 1.*m, 1.*m, 1.*m);
+  G4LogicalVolume* world_logic =
+    new G4LogicalVolume(world_solid, vacuum, "WORLD");
+  G4VPhysicalVolume* world =
+    new G4PVPlacement(0, G4ThreeVector(), world_logic, "WORLD", 0, false, 0);
+
+  // Two copies of a tube with a box inside
+  G4Tubs* tube_solid = new G4Tubs("TUBE", 0., 100.*mm, 50.*mm, 0., twopi);
+  G4LogicalVolume* tube_logic =
+    new G4LogicalVolume(tube_solid, vacuum, "TUBE");
+  const G4ThreeVector tube_pos[2] = {G4ThreeVector(300.*mm, 0., 0.),
+                                     G4ThreeVector(-300.*mm, 0., 100.*mm)};
+  for (G4int i=0; i<2; ++i)
+    new G4PVPlacement(0, tube_pos[i], tube_logic, "TUBE", world_logic, false, i);
+
+  G4Box* hole_solid = new G4Box("HOLE", 20.*mm, 20.*mm, 20.*mm);
+  G4LogicalVolume* hole_logic =
+    new G4LogicalVolume(hole_solid, vacuum, "HOLE");
+  const G4ThreeVector hole_pos(30.*mm, 0., 0.);
+  new G4PVPlacement(0, hole_pos, hole_logic, "HOLE", tube_logic, false, 0);
+
+  // A ball with a smaller one inside
+  G4Orb* ball_solid = new G4Orb("BALL", 80.*mm);
+  G4LogicalVolume* ball_logic =
+    new G4LogicalVolume(ball_solid, vacuum, "BALL");
+  const G4ThreeVector ball_pos(0., 400.*mm, 0.);
+  new G4PVPlacement(0, ball_pos, ball_logic, "BALL", world_logic, false, 0);
+
+  G4Orb* core_solid = new G4Orb("CORE", 30.*mm);
+  G4LogicalVolume* core_logic =
+    new G4LogicalVolume(core_solid, vacuum, "CORE");
+  const G4ThreeVector core_pos(0., 0., 20.*mm);
+  new G4PVPlacement(0, core_pos, core_logic, "CORE", ball_logic, false, 0);
+
+  G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->SetWorldVolume(world);
+
+  SECTION ("Tubes") {
+    nexus::VolumePointSampler sampler("TUBE");
+    G4int copies[2] = {0, 0};
+    for (G4int i=0; i<10000; ++i) {
+      G4ThreeVector p = sampler.Shoot();
+      G4int n_inside = 0;
+      for (G4int k=0; k<2; ++k) {
+        G4ThreeVector local = p - tube_pos[k];
+        if (tube_solid->Inside(local) == kOutside) continue;
+        ++n_inside;
+        ++copies[k];
+        REQUIRE(hole_solid->Inside(local - hole_pos) == kOutside);
+      }
+      REQUIRE(n_inside == 1);
+    }
+    REQUIRE(copies[0] > 4500);
+    REQUIRE(copies[1] > 4500);
+  }
+
+  SECTION ("Other solids") {
+    nexus::VolumePointSampler sampler("BALL", true);
+    for (G4int i=0; i<10000; ++i) {
+      G4ThreeVector local = sampler.Shoot() - ball_pos;
+      REQUIRE(ball_solid->Inside(local) != kOutside);
+      REQUIRE(core_solid->Inside(local - core_pos) == kOutside);
+    }
+  }
+}
@@ -0,0 +1,222 @@
+// ----------------------------------------------------------------------------
+// nexus | CellPointSampler.cc
+//
+// This class is a sampler of random uniform points in the part of a
+// region that lies inside a given set of physical volumes. The region
+// is described by a map from the unit cube to space that transforms
+// uniform numbers into uniform points, such as the GetVolumePoint
+// method of the point samplers. The unit cube is divided into cells of
+// equal volume and similar size along the three directions, classified
+// once with the navigator as inside, outside or crossed by the boundary
+// of the volumes. Points are then drawn from a random cell that is not
+// outside, and checked with the navigator only when the cell is crossed
+// by the boundary. The navigator can be replaced by user functions, for
+// instance to sample points in a solid in its own coordinates.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "CellPointSampler.h"
+
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4VPhysicalVolume.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace nexus;
+
+
+namespace {
+  const uint32_t BOUNDARY_CELL = 1u << 31;
+}
+
+
+
+CellPointSampler::CellPointSampler(PointMap map,
+                                   const std::vector<G4String>& volume_names,
+                                   const G4ThreeVector& offset,
+                                   G4int max_cells):
+  map_(map), volume_names_(volume_names), offset_(offset),
+  max_cells_(max_cells)
+{
+  if (max_cells_ < 1) {
+    G4Exception("[CellPointSampler]", "CellPointSampler()", FatalException,
+                "The maximum number of cells must be positive.");
+  }
+  div_[0] = div_[1] = div_[2] = 1;
+}
+
+
+
+CellPointSampler::CellPointSampler(PointMap map,
+                                   InsideFunction inside,
+                                   SafetyFunction safety,
+                                   G4int max_cells):
+  map_(map), offset_(0., 0., 0.),
+  inside_(inside), safety_(safety), max_cells_(max_cells)
+{
+  if (max_cells_ < 1) {
+    G4Exception("[CellPointSampler]", "CellPointSampler()", FatalException,
+                "The maximum number of cells must be positive.");
+  }
+  div_[0] = div_[1] = div_[2] = 1;
+}
+
+
+
+CellPointSampler::~CellPointSampler()
+{
+}
+
+
+
+void CellPointSampler::SetDivisions()
+{
+  // Length of the region along each dimension of the unit cube,
+  // averaged over a few lines and following their curvature
+  const G4int nsteps = 16;
+  G4double length[3] = {0., 0., 0.};
+
+  for (G4int d=0; d<3; ++d) {
+    for (G4int a=1; a<4; ++a) {
+      for (G4int b=1; b<4; ++b) {
+        G4double u[3];
+        u[(d+1)%3] = a / 4.;
+        u[(d+2)%3] = b / 4.;
+        u[d] = 0.;
+        G4ThreeVector prev = map_(u[0], u[1], u[2]);
+        for (G4int s=1; s<=nsteps; ++s) {
+          u[d] = G4double(s) / nsteps;
+          G4ThreeVector next = map_(u[0], u[1], u[2]);
+          length[d] += (next - prev).mag() / 9.;
+          prev = next;
+        }
+      }
+    }
+  }
+
+  // Size of the cells filling the region with the maximum number
+  // of them, ignoring the dimensions along which it is flat
+  G4double max_length = std::max({length[0], length[1], length[2]});
+  G4double volume = 1.;
+  G4int num_dims = 0;
+  for (G4int d=0; d<3; ++d) {
+    if (length[d] > 1.e-6 * max_length) {
+      volume *= length[d];
+      ++num_dims;
+    }
+  }
+
+  div_[0] = div_[1] = div_[2] = 1;
+  if (num_dims == 0) return;
+
+  G4double size = std::pow(volume / max_cells_, 1. / num_dims);
+  for (G4int d=0; d<3; ++d)
+    if (length[d] > 1.e-6 * max_length)
+      div_[d] = std::min(std::max(G4int(length[d] / size), 1), 1024);
+}
+
+
+
+void CellPointSampler::Build()
+{
+  // Volumes given by name are classified with the navigator
+  if (!inside_) {
+    for (const G4VPhysicalVolume* pv: *G4PhysicalVolumeStore::GetInstance())
+      if (std::find(volume_names_.begin(), volume_names_.end(),
+                    pv->GetName()) != volume_names_.end())
+        volumes_.push_back(pv);
+
+    // The navigator of the thread calling the functions is used
+    inside_ = [this](const G4ThreeVector& point) {
+      const G4VPhysicalVolume* pv =
+        G4TransportationManager::GetTransportationManager()->
+        GetNavigatorForTracking()->LocateGlobalPointAndSetup(point + offset_, 0, false);
+      return std::find(volumes_.begin(), volumes_.end(), pv) != volumes_.end();
+    };
+    safety_ = [this](const G4ThreeVector& point) {
+      return G4TransportationManager::GetTransportationManager()->
+        GetNavigatorForTracking()->ComputeSafety(point + offset_);
+    };
+  }
+
+  SetDivisions();
+
+  const G4int n0 = div_[0], n1 = div_[1], n2 = div_[2];
+  const G4int m1 = n1 + 1, m2 = n2 + 1;
+
+  // Points at the corners of all the cells
+  std::vector<G4ThreeVector> corners((n0+1)*m1*m2);
+  for (G4int i=0; i<=n0; ++i)
+    for (G4int j=0; j<=n1; ++j)
+      for (G4int k=0; k<=n2; ++k)
+        corners[(i*m1 + j)*m2 + k] =
+          map_(G4double(i)/n0, G4double(j)/n1, G4double(k)/n2);
+
+  for (G4int i=0; i<n0; ++i) {
+    for (G4int j=0; j<n1; ++j) {
+      for (G4int k=0; k<n2; ++k) {
+
+        G4ThreeVector center = map_((i+.5)/n0, (j+.5)/n1, (k+.5)/n2);
+
+        // Distance from the center to the farthest corner
+        G4double radius = 0.;
+        for (G4int c=0; c<8; ++c) {
+          G4int ci = i + ((c>>2) & 1);
+          G4int cj = j + ((c>>1) & 1);
+          G4int ck = k + (c & 1);
+          radius = std::max(radius, (corners[(ci*m1 + cj)*m2 + ck] - center).mag());
+        }
+
+        // The cell lies entirely on the side of its center if no
+        // boundary is closer to the center than the farthest corner
+        G4bool inside = inside_(center);
+        G4bool crossed = safety_(center) < radius;
+
+        uint32_t cell = (i*n1 + j)*n2 + k;
+        if (crossed)     cells_.push_back(cell | BOUNDARY_CELL);
+        else if (inside) cells_.push_back(cell);
+      }
+    }
+  }
+}
+
+
+
+G4ThreeVector CellPointSampler::Shoot()
+{
+  std::call_once(built_, &CellPointSampler::Build, this);
+
+  if (cells_.empty()) {
+    G4Exception("[CellPointSampler]", "Shoot()", FatalException,
+                "The region does not overlap with the volumes.");
+  }
+
+  while (true) {
+    size_t idx = std::min(size_t(G4UniformRand() * cells_.size()),
+                          cells_.size() - 1);
+    uint32_t cell = cells_[idx];
+
+    G4double u1 = G4UniformRand();
+    G4double u2 = G4UniformRand();
+    G4double u3 = G4UniformRand();
+    G4ThreeVector point = CellPoint(cell & ~BOUNDARY_CELL, u1, u2, u3);
+
+    if (!(cell & BOUNDARY_CELL) || inside_(point)) return point;
+  }
+}
+
+
+
+G4ThreeVector CellPointSampler::CellPoint(uint32_t cell,
+                                          G4double u1, G4double u2, G4double u3) const
+{
+  G4int k = cell % div_[2];
+  G4int j = (cell / div_[2]) % div_[1];
+  G4int i = cell / (div_[2] * div_[1]);
+  return map_((i + u1) / div_[0], (j + u2) / div_[1], (k + u3) / div_[2]);
+}
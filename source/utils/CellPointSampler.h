@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------------------
+// nexus | CellPointSampler.h
+//
+// This class is a sampler of random uniform points in the part of a
+// region that lies inside a given set of physical volumes. The region
+// is described by a map from the unit cube to space that transforms
+// uniform numbers into uniform points, such as the GetVolumePoint
+// method of the point samplers. The unit cube is divided into cells of
+// equal volume and similar size along the three directions, classified
+// once with the navigator as inside, outside or crossed by the boundary
+// of the volumes. Points are then drawn from a random cell that is not
+// outside, and checked with the navigator only when the cell is crossed
+// by the boundary. The navigator can be replaced by user functions, for
+// instance to sample points in a solid in its own coordinates.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef CELL_POINT_SAMPLER_H
+#define CELL_POINT_SAMPLER_H
+
+#include <G4ThreeVector.hh>
+
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+class G4VPhysicalVolume;
+
+
+namespace nexus {
+
+  class CellPointSampler
+  {
+  public:
+    /// Map from three numbers in [0,1) to a point of the region
+    typedef std::function<G4ThreeVector(G4double, G4double, G4double)> PointMap;
+    /// Returns true if a point is in the part of the region sampled
+    typedef std::function<G4bool(const G4ThreeVector&)> InsideFunction;
+    /// Returns a lower bound of the distance from a point to the
+    /// nearest boundary between sampled and not sampled space
+    typedef std::function<G4double(const G4ThreeVector&)> SafetyFunction;
+
+    /// Constructor providing the map of the region, the names of the
+    /// physical volumes where points are accepted, the translation from
+    /// the coordinates given by the map to global coordinates, and the
+    /// maximum number of cells
+    CellPointSampler(PointMap map,
+                     const std::vector<G4String>& volume_names,
+                     const G4ThreeVector& offset = G4ThreeVector(0., 0., 0.),
+                     G4int max_cells = 1<<18);
+
+    /// Constructor providing the map of the region and the functions
+    /// used to classify the cells, all in the same coordinates
+    CellPointSampler(PointMap map, InsideFunction inside, SafetyFunction safety,
+                     G4int max_cells = 1<<18);
+
+    /// Destructor
+    ~CellPointSampler();
+
+    /// Returns a random point in the coordinates of the map. The cells
+    /// are classified the first time, when the geometry is closed.
+    G4ThreeVector Shoot();
+
+  private:
+    /// Classifies the cells of the unit cube
+    void Build();
+
+    /// Chooses the number of cells along each dimension so that
+    /// their size in space is similar along the three directions
+    void SetDivisions();
+
+    G4ThreeVector CellPoint(uint32_t cell, G4double, G4double, G4double) const;
+
+  private:
+    PointMap map_;
+    std::vector<G4String> volume_names_;
+    G4ThreeVector offset_;
+    InsideFunction inside_;
+    SafetyFunction safety_;
+    G4int max_cells_;
+    G4int div_[3]; ///< Number of cells along each dimension
+
+    std::once_flag built_;
+    std::vector<const G4VPhysicalVolume*> volumes_;
+
+    /// Cells not outside the volumes: index of the cell in the cube,
+    /// with the highest bit set if the cell is crossed by the boundary
+    std::vector<uint32_t> cells_;
+  };
+
+} // end namespace nexus
+
+#endif
@@ -69,11 +69,10 @@ namespace nexus {
 
     // Generating from inside the cylinder (between minRad and maxRad)
     else if (region == "VOLUME") {
-      G4double phi = GetPhi();
-      G4double rad = GetRadius(minRad_, maxRad_);
-      x = rad * cos(phi);
-      y = rad * sin(phi);
-      z = GetLength(halfLength_);
+      G4double u_phi = G4UniformRand();
+      G4double u_rad = G4UniformRand();
+      G4double u_z   = G4UniformRand();
+      return GetVolumePoint(u_phi, u_rad, u_z);
     }
 
     // Generating from the INNER surface
@@ -105,6 +104,18 @@ namespace nexus {
 
 
 
+  G4ThreeVector CylinderPointSampler2020::GetVolumePoint(G4double u_phi,
+                                                         G4double u_rad,
+                                                         G4double u_z) const
+  {
+    G4double phi = iniPhi_ + u_phi * deltaPhi_;
+    G4double rad = sqrt((1.-u_rad) * minRad_*minRad_ + u_rad * maxRad_*maxRad_);
+    G4double z   = (u_z * 2.0 - 1.0) * halfLength_;
+    return RotateAndTranslate(G4ThreeVector(rad * cos(phi), rad * sin(phi), z));
+  }
+
+
+
   G4double CylinderPointSampler2020::GetRadius(G4double innerRad, G4double outerRad)
   {
     G4double rand = G4UniformRand();
@@ -128,7 +139,7 @@ namespace nexus {
 
 
 
-  G4ThreeVector CylinderPointSampler2020::RotateAndTranslate(G4ThreeVector position)
+  G4ThreeVector CylinderPointSampler2020::RotateAndTranslate(G4ThreeVector position) const
   {
     // Rotating if needed
     if (rotation_) position *= *rotation_;
@@ -41,11 +41,15 @@ namespace nexus {
     // Returns vertex within region <region> of the chamber
     G4ThreeVector GenerateVertex(const G4String& region);
 
+    // Returns the point of the volume corresponding to three numbers
+    // in [0,1). Uniform numbers give uniform points in the volume.
+    G4ThreeVector GetVolumePoint(G4double u_phi, G4double u_rad, G4double u_z) const;
+
   private:
     G4double      GetRadius(G4double innerRad, G4double outerRad);
     G4double      GetPhi();
     G4double      GetLength(G4double halfLength);
-    G4ThreeVector RotateAndTranslate(G4ThreeVector position);
+    G4ThreeVector RotateAndTranslate(G4ThreeVector position) const;
 
   private:
     G4double          minRad_, maxRad_, halfLength_;  // Solid Dimensions
@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPhotonBatch.cc
+//
+// This class generates the directions, polarizations and energies of
+// a batch of isotropically emitted optical photons. They are stored as
+// separate arrays and computed in simple loops over the whole batch,
+// from random numbers drawn in bulk.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalPhotonBatch.h"
+
+#include "SpectrumSampler.h"
+
+#include <Randomize.hh>
+
+#include "CLHEP/Units/PhysicalConstants.h"
+
+#include <cmath>
+
+using namespace nexus;
+
+
+
+OpticalPhotonBatch::OpticalPhotonBatch(): size_(0)
+{
+}
+
+
+
+OpticalPhotonBatch::~OpticalPhotonBatch()
+{
+}
+
+
+
+void OpticalPhotonBatch::Resize(G4int n)
+{
+  size_ = n;
+  if (G4int(dir_x_.size()) >= n) return;
+
+  rnd_.resize(3*n);
+  dir_x_.resize(n); dir_y_.resize(n); dir_z_.resize(n);
+  pol_x_.resize(n); pol_y_.resize(n); pol_z_.resize(n);
+  energy_.resize(n);
+}
+
+
+
+void OpticalPhotonBatch::Generate(G4int n)
+{
+  Resize(n);
+  if (n <= 0) return;
+
+  // Three random numbers per photon: polar and azimuthal
+  // angles of the direction, and angle of the polarization
+  G4Random::getTheEngine()->flatArray(3*n, rnd_.data());
+
+  const G4double* u_cos_theta = rnd_.data();
+  const G4double* u_phi = rnd_.data() + n;
+  const G4double* u_psi = rnd_.data() + 2*n;
+
+  G4double* __restrict__ dx = dir_x_.data();
+  G4double* __restrict__ dy = dir_y_.data();
+  G4double* __restrict__ dz = dir_z_.data();
+  G4double* __restrict__ px = pol_x_.data();
+  G4double* __restrict__ py = pol_y_.data();
+  G4double* __restrict__ pz = pol_z_.data();
+
+  for (G4int i=0; i<n; ++i) {
+    G4double cos_theta = 1. - 2.*u_cos_theta[i];
+    G4double sin_theta = std::sqrt((1.-cos_theta)*(1.+cos_theta));
+    G4double phi = CLHEP::twopi * u_phi[i];
+    G4double cos_phi = std::cos(phi);
+    G4double sin_phi = std::sin(phi);
+    G4double psi = CLHEP::twopi * u_psi[i];
+    G4double cos_psi = std::cos(psi);
+    G4double sin_psi = std::sin(psi);
+
+    dx[i] = sin_theta * cos_phi;
+    dy[i] = sin_theta * sin_phi;
+    dz[i] = cos_theta;
+
+    // The polarization is rotated by psi around the direction, starting
+    // from (cos_theta cos_phi, cos_theta sin_phi, -sin_theta). The cross
+    // product of the direction and this vector is (-sin_phi, cos_phi, 0).
+    // Both vectors are unit and orthogonal, so is the result.
+    px[i] = cos_psi * cos_theta * cos_phi - sin_psi * sin_phi;
+    py[i] = cos_psi * cos_theta * sin_phi + sin_psi * cos_phi;
+    pz[i] = -cos_psi * sin_theta;
+  }
+}
+
+
+
+void OpticalPhotonBatch::Generate(G4int n, const SpectrumSampler& spectrum)
+{
+  Generate(n);
+  if (n > 0) spectrum.Shoot(n, energy_.data());
+}
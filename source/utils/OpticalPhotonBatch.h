@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalPhotonBatch.h
+//
+// This class generates the directions, polarizations and energies of
+// a batch of isotropically emitted optical photons. They are stored as
+// separate arrays and computed in simple loops over the whole batch,
+// from random numbers drawn in bulk.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_PHOTON_BATCH_H
+#define OPTICAL_PHOTON_BATCH_H
+
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class SpectrumSampler;
+
+  class OpticalPhotonBatch
+  {
+  public:
+    /// Constructor
+    OpticalPhotonBatch();
+    /// Destructor
+    ~OpticalPhotonBatch();
+
+    /// Generates n photons with random isotropic directions and
+    /// random polarizations perpendicular to them
+    void Generate(G4int n);
+
+    /// As above, with energies sampled from a spectrum as well
+    void Generate(G4int n, const SpectrumSampler&);
+
+    /// Number of photons in the batch
+    G4int size() const;
+
+    G4ThreeVector GetDirection(G4int i) const;
+    G4ThreeVector GetPolarization(G4int i) const;
+    /// Energy of the photon (only if generated with a spectrum)
+    G4double GetEnergy(G4int i) const;
+
+  private:
+    void Resize(G4int n);
+
+  private:
+    G4int size_;
+
+    std::vector<G4double> rnd_; ///< Buffer of random numbers
+
+    std::vector<G4double> dir_x_, dir_y_, dir_z_;
+    std::vector<G4double> pol_x_, pol_y_, pol_z_;
+    std::vector<G4double> energy_;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline G4int OpticalPhotonBatch::size() const
+  { return size_; }
+
+  inline G4ThreeVector OpticalPhotonBatch::GetDirection(G4int i) const
+  { return G4ThreeVector(dir_x_[i], dir_y_[i], dir_z_[i]); }
+
+  inline G4ThreeVector OpticalPhotonBatch::GetPolarization(G4int i) const
+  { return G4ThreeVector(pol_x_[i], pol_y_[i], pol_z_[i]); }
+
+  inline G4double OpticalPhotonBatch::GetEnergy(G4int i) const
+  { return energy_[i]; }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,99 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.cc
+//
+// This class is a sampler of random energies following a tabulated
+// spectrum, by inversion of its cumulative distribution. A guide table
+// on a uniform grid of probabilities gives the bin of the inverse in
+// constant expected time, without a binary search.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SpectrumSampler.h"
+
+#include <algorithm>
+
+using namespace nexus;
+
+
+
+SpectrumSampler::SpectrumSampler(): guide_size_(0.)
+{
+}
+
+
+
+SpectrumSampler::SpectrumSampler(const G4PhysicsVector& spectrum):
+  guide_size_(0.)
+{
+  std::vector<G4double> energies(spectrum.GetVectorLength());
+  std::vector<G4double> intensities(spectrum.GetVectorLength());
+  for (size_t i=0; i<spectrum.GetVectorLength(); ++i) {
+    energies[i] = spectrum.Energy(i);
+    intensities[i] = spectrum[i];
+  }
+  Build(energies, intensities);
+}
+
+
+
+SpectrumSampler::SpectrumSampler(const std::vector<G4double>& energies,
+                                 const std::vector<G4double>& intensities):
+  guide_size_(0.)
+{
+  Build(energies, intensities);
+}
+
+
+
+SpectrumSampler::~SpectrumSampler()
+{
+}
+
+
+
+void SpectrumSampler::Build(const std::vector<G4double>& energies,
+                            const std::vector<G4double>& intensities)
+{
+  size_t n = std::min(energies.size(), intensities.size());
+  if (n < 2) return;
+
+  // Cumulative distribution with the trapezoidal rule,
+  // as for the integrals used by G4Scintillation
+  std::vector<G4double> cdf(n, 0.);
+  for (size_t i=1; i<n; ++i)
+    cdf[i] = cdf[i-1] + 0.5 * (energies[i] - energies[i-1]) *
+      (intensities[i] + intensities[i-1]);
+
+  G4double total = cdf[n-1];
+  if (!(total > 0.)) return;
+
+  for (auto& c: cdf) c /= total;
+  cdf[n-1] = 1.;
+
+  energies_.assign(energies.begin(), energies.begin() + n);
+  cdf_.swap(cdf);
+
+  // A few guide entries per bin keep the linear search
+  // to one or two steps for smooth spectra
+  G4int num_bins = n - 1;
+  G4int size = 4 * num_bins;
+  guide_.resize(size + 1);
+  guide_size_ = size;
+
+  G4int bin = 0;
+  for (G4int k=0; k<=size; ++k) {
+    G4double u = G4double(k) / size;
+    while (bin < num_bins - 1 && cdf_[bin+1] <= u) ++bin;
+    guide_[k] = bin;
+  }
+}
+
+
+
+void SpectrumSampler::Shoot(G4int n, G4double* energies) const
+{
+  G4Random::getTheEngine()->flatArray(n, energies);
+  for (G4int i=0; i<n; ++i)
+    energies[i] = GetEnergy(energies[i]);
+}
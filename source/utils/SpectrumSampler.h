@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------------
+// nexus | SpectrumSampler.h
+//
+// This class is a sampler of random energies following a tabulated
+// spectrum, by inversion of its cumulative distribution. A guide table
+// on a uniform grid of probabilities gives the bin of the inverse in
+// constant expected time, without a binary search.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SPECTRUM_SAMPLER_H
+#define SPECTRUM_SAMPLER_H
+
+#include <G4PhysicsVector.hh>
+#include <Randomize.hh>
+
+#include <vector>
+#include <cassert>
+
+
+namespace nexus {
+
+  class SpectrumSampler
+  {
+  public:
+    /// Default constructor. The sampler is empty.
+    SpectrumSampler();
+
+    /// Constructor providing the spectrum: intensity as a function of
+    /// energy, linear between the points given
+    SpectrumSampler(const G4PhysicsVector& spectrum);
+
+    /// Constructor providing the energies and intensities of the spectrum
+    SpectrumSampler(const std::vector<G4double>& energies,
+                    const std::vector<G4double>& intensities);
+
+    /// Destructor
+    ~SpectrumSampler();
+
+    /// Returns true if there is no spectrum (or its integral is zero)
+    G4bool IsEmpty() const;
+
+    /// Returns the energy corresponding to a given value
+    /// of the cumulative distribution, in [0,1).
+    /// The sampler must not be empty.
+    G4double GetEnergy(G4double cdf_value) const;
+
+    /// Generates a random energy
+    G4double Shoot() const;
+
+    /// Fills an array with n random energies
+    void Shoot(G4int n, G4double* energies) const;
+
+  private:
+    void Build(const std::vector<G4double>& energies,
+               const std::vector<G4double>& intensities);
+
+  private:
+    std::vector<G4double> energies_;
+    std::vector<G4double> cdf_;  ///< Normalized cumulative distribution
+    /// Last bin of the cumulative distribution starting at or below
+    /// k/guide_size_, for k = 0, ..., guide_size_
+    std::vector<G4int> guide_;
+    G4double guide_size_;
+  };
+
+  // INLINE METHODS ////////////////////////////////////////////////////////////
+
+  inline G4bool SpectrumSampler::IsEmpty() const
+  { return cdf_.empty(); }
+
+  inline G4double SpectrumSampler::GetEnergy(G4double u) const
+  {
+    assert(!IsEmpty());
+    G4int i = guide_[G4int(u * guide_size_)];
+    const G4int last = cdf_.size() - 2;
+    while (i < last && cdf_[i+1] <= u) ++i;
+    return energies_[i] + (energies_[i+1] - energies_[i]) *
+      (u - cdf_[i]) / (cdf_[i+1] - cdf_[i]);
+  }
+
+  inline G4double SpectrumSampler::Shoot() const
+  { return GetEnergy(G4UniformRand()); }
+
+} // end namespace nexus
+
+#endif
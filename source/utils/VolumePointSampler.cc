@@ -0,0 +1,278 @@
+// ----------------------------------------------------------------------------
+// nexus | VolumePointSampler.cc
+//
+// This class is a sampler of random uniform points in all the copies of
+// a physical or logical volume, given by name. The copies are found in
+// the geometry tree the first time a point is requested and one of them
+// is chosen with probability proportional to its volume or mass, using
+// an alias table. Points are generated in the coordinates of the solid,
+// directly for boxes and tubes without daughters, and from a cache of
+// cells of the solid otherwise, and then moved to the copy. Geant4 has
+// no exact volume for boolean solids, which is estimated by Monte Carlo
+// here with a fixed number of points (relative precision of about 0.1%).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "VolumePointSampler.h"
+
+#include "CylinderPointSampler2020.h"
+
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4Box.hh>
+#include <G4Tubs.hh>
+#include <G4BooleanSolid.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+
+using namespace nexus;
+
+
+namespace {
+
+  /// Daughter of a logical volume, excluded from the sampled points
+  struct Daughter {
+    const G4VSolid* solid;
+    G4AffineTransform transform; ///< From mother to daughter coordinates
+  };
+
+  /// Maximum number of cells per solid
+  const G4int MAX_CELLS = 1<<15;
+
+  /// Number of points and surface tolerance of the
+  /// estimation of the volume of boolean solids
+  const G4int VOLUME_POINTS = 1000000;
+  const G4double VOLUME_EPSILON = 0.001;
+
+  /// Volume of a solid, estimated with an explicit precision
+  /// for boolean solids, whose volume is not exact
+  G4double CubicVolume(G4VSolid* solid)
+  {
+    if (dynamic_cast<G4BooleanSolid*>(solid))
+      return solid->EstimateCubicVolume(VOLUME_POINTS, VOLUME_EPSILON);
+    return solid->GetCubicVolume();
+  }
+}
+
+
+
+VolumePointSampler::VolumePointSampler(const G4String& name,
+                                       G4bool mass_weighted):
+  name_(name), mass_weighted_(mass_weighted)
+{
+}
+
+
+
+VolumePointSampler::~VolumePointSampler()
+{
+}
+
+
+
+G4ThreeVector VolumePointSampler::Shoot()
+{
+  std::call_once(built_, &VolumePointSampler::Build, this);
+
+  G4double u = G4UniformRand() * placements_.size();
+  size_t i = std::min(size_t(u), placements_.size() - 1);
+  if (u - i >= prob_[i]) i = alias_[i];
+
+  const Placement& placement = placements_[i];
+  SolidSampler& solid = solids_[placement.solid];
+
+  G4ThreeVector point;
+  if (solid.cells) {
+    point = solid.cells->Shoot();
+  } else {
+    G4double u1 = G4UniformRand();
+    G4double u2 = G4UniformRand();
+    G4double u3 = G4UniformRand();
+    point = solid.map(u1, u2, u3);
+  }
+
+  return placement.transform.TransformPoint(point);
+}
+
+
+
+void VolumePointSampler::Build()
+{
+  const G4VPhysicalVolume* world =
+    G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->GetWorldVolume();
+
+  CollectPlacements(world, G4AffineTransform());
+
+  if (placements_.empty()) {
+    G4Exception("[VolumePointSampler]", "Build()", FatalException,
+                ("No placement of the volume " + name_ + " found.").c_str());
+  }
+
+  BuildAliasTable();
+}
+
+
+
+void VolumePointSampler::CollectPlacements(const G4VPhysicalVolume* pv,
+                                           const G4AffineTransform& mother)
+{
+  // Replicas and parameterised volumes have no fixed placement
+  if (pv->IsReplicated()) {
+    G4Exception("[VolumePointSampler]", "CollectPlacements()", JustWarning,
+                ("Replicated volume " + pv->GetName() + " skipped.").c_str());
+    return;
+  }
+
+  G4AffineTransform transform =
+    G4AffineTransform(pv->GetRotation(), pv->GetTranslation()) * mother;
+
+  const G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+  if (pv->GetName() == name_ || lv->GetName() == name_) {
+    placements_.push_back({transform, GetSolidSampler(lv)});
+    return;
+  }
+
+  for (size_t i=0; i<lv->GetNoDaughters(); ++i)
+    CollectPlacements(lv->GetDaughter(i), transform);
+}
+
+
+
+size_t VolumePointSampler::GetSolidSampler(const G4LogicalVolume* lv)
+{
+  auto it = solid_index_.find(lv);
+  if (it != solid_index_.end()) return it->second;
+
+  G4VSolid* solid = lv->GetSolid();
+
+  SolidSampler sampler;
+  G4bool exact_map = true;
+
+  if (solid->GetEntityType() == "G4Box") {
+    const G4Box* box = static_cast<const G4Box*>(solid);
+    G4ThreeVector half(box->GetXHalfLength(), box->GetYHalfLength(),
+                       box->GetZHalfLength());
+    sampler.map = [half](G4double u1, G4double u2, G4double u3) {
+      return G4ThreeVector((2.*u1 - 1.) * half.x(),
+                           (2.*u2 - 1.) * half.y(),
+                           (2.*u3 - 1.) * half.z());
+    };
+  }
+  else if (solid->GetEntityType() == "G4Tubs") {
+    const G4Tubs* tubs = static_cast<const G4Tubs*>(solid);
+    auto cylinder = std::make_shared<CylinderPointSampler2020>
+      (tubs->GetInnerRadius(), tubs->GetOuterRadius(), tubs->GetZHalfLength(),
+       tubs->GetStartPhiAngle(), tubs->GetDeltaPhiAngle());
+    sampler.map = [cylinder](G4double u1, G4double u2, G4double u3) {
+      return cylinder->GetVolumePoint(u1, u2, u3);
+    };
+  }
+  else {
+    // Other solids are sampled in their bounding box
+    G4ThreeVector pmin, pmax;
+    solid->BoundingLimits(pmin, pmax);
+    G4ThreeVector size = pmax - pmin;
+    sampler.map = [pmin, size](G4double u1, G4double u2, G4double u3) {
+      return pmin + G4ThreeVector(u1 * size.x(), u2 * size.y(), u3 * size.z());
+    };
+    exact_map = false;
+  }
+
+  // Points inside the daughters are not part of the volume
+  auto daughters = std::make_shared<std::vector<Daughter>>();
+  G4double volume = CubicVolume(solid);
+
+  for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+    const G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    if (pv->IsReplicated()) {
+      G4Exception("[VolumePointSampler]", "GetSolidSampler()", JustWarning,
+                  ("Replicated daughter " + pv->GetName() + " ignored.").c_str());
+      continue;
+    }
+    G4VSolid* daughter = pv->GetLogicalVolume()->GetSolid();
+    G4AffineTransform transform(pv->GetRotation(), pv->GetTranslation());
+    daughters->push_back({daughter, transform.Inverse()});
+    volume -= CubicVolume(daughter);
+  }
+
+  if (!exact_map || !daughters->empty()) {
+    auto inside = [solid, daughters](const G4ThreeVector& p) {
+      if (solid->Inside(p) == kOutside) return false;
+      for (const Daughter& d: *daughters)
+        if (d.solid->Inside(d.transform.TransformPoint(p)) != kOutside)
+          return false;
+      return true;
+    };
+
+    auto safety = [solid, daughters](const G4ThreeVector& p) {
+      if (solid->Inside(p) == kOutside) return solid->DistanceToIn(p);
+      G4double distance = solid->DistanceToOut(p);
+      for (const Daughter& d: *daughters) {
+        G4ThreeVector q = d.transform.TransformPoint(p);
+        distance = std::min(distance, d.solid->Inside(q) == kOutside ?
+                            d.solid->DistanceToIn(q) : d.solid->DistanceToOut(q));
+      }
+      return distance;
+    };
+
+    sampler.cells.reset(new CellPointSampler(sampler.map, inside, safety, MAX_CELLS));
+  }
+
+  sampler.weight = volume;
+  if (mass_weighted_) sampler.weight *= lv->GetMaterial()->GetDensity();
+
+  solids_.push_back(std::move(sampler));
+  solid_index_[lv] = solids_.size() - 1;
+  return solids_.size() - 1;
+}
+
+
+
+void VolumePointSampler::BuildAliasTable()
+{
+  // Walker's alias method, which allows choosing
+  // a placement with a single random number
+  size_t n = placements_.size();
+
+  std::vector<G4double> p(n);
+  G4double total = 0.;
+  for (size_t i=0; i<n; ++i) {
+    p[i] = std::max(solids_[placements_[i].solid].weight, 0.);
+    total += p[i];
+  }
+
+  if (total <= 0.) {
+    G4Exception("[VolumePointSampler]", "BuildAliasTable()", FatalException,
+                ("The volume " + name_ + " has no mass or volume.").c_str());
+  }
+
+  prob_.assign(n, 1.);
+  alias_.resize(n);
+
+  std::vector<size_t> small, large;
+  for (size_t i=0; i<n; ++i) {
+    alias_[i] = i;
+    p[i] *= n / total;
+    if (p[i] < 1.) small.push_back(i);
+    else           large.push_back(i);
+  }
+
+  while (!small.empty() && !large.empty()) {
+    size_t s = small.back(); small.pop_back();
+    size_t l = large.back();
+    prob_[s]  = p[s];
+    alias_[s] = l;
+    p[l] -= 1. - p[s];
+    if (p[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+}